@@ -15,6 +15,7 @@
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #include "audioencoder.h"
+#include <algorithm>
 
 
 AudioEncoder::AudioEncoder()
@@ -30,118 +31,216 @@ AudioEncoder::AudioEncoder()
     {
         qDebug() << "audio decoder creation failed";
     }
-    _codec2 = codec2_create(CODEC2_MODE_1400);
-    _codec2_700 = codec2_create(CODEC2_MODE_700B);
+    _repacketizer = opus_repacketizer_create();
+    for(int i=0;i<gr_modem_types::Codec2ModeCount;i++)
+        _codec2[i] = 0;
 
     _gsm = gsm_create();
     _agc = hvdi::initAGC(0.5);
 
+    set_opus_profile(OpusProfileQuality);
+    opus_decoder_ctl(_dec, OPUS_SET_GAIN(-3));
+}
+
+static const AudioEncoder::opus_profile opus_profiles[AudioEncoder::OpusProfileCount] =
+{
+    {9400, 10, false, false, false, 100},
+    {9400, 10, true, true, true, 20},
+    {9400, 3, true, false, true, 0},
+};
+
+void AudioEncoder::set_opus_profile(int profile, int bitrate, int complexity, int packet_loss_perc)
+{
+    if((profile < 0) || (profile >= OpusProfileCount))
+        profile = OpusProfileQuality;
+    _opus_profile = opus_profiles[profile];
+    if(bitrate > 0)
+        _opus_profile.bitrate = bitrate;
+    if(complexity >= 0)
+        _opus_profile.complexity = std::min(10, complexity);
+    if(packet_loss_perc >= 0)
+        _opus_profile.packet_loss_perc = std::min(100, packet_loss_perc);
+
     int opus_bandwidth;
-    opus_encoder_ctl(_enc, OPUS_SET_VBR(0));
-    opus_encoder_ctl(_enc, OPUS_SET_BITRATE(9400));
-    opus_encoder_ctl(_enc, OPUS_SET_COMPLEXITY(10));
-    //opus_encoder_ctl(_enc, OPUS_SET_DTX(1));
+    opus_encoder_ctl(_enc, OPUS_SET_VBR(_opus_profile.vbr ? 1 : 0));
+    opus_encoder_ctl(_enc, OPUS_SET_BITRATE(_opus_profile.bitrate));
+    opus_encoder_ctl(_enc, OPUS_SET_COMPLEXITY(_opus_profile.complexity));
+    opus_encoder_ctl(_enc, OPUS_SET_DTX(_opus_profile.dtx ? 1 : 0));
     opus_encoder_ctl(_enc, OPUS_SET_LSB_DEPTH(16));
     opus_encoder_ctl(_enc, OPUS_SET_MAX_BANDWIDTH(OPUS_BANDWIDTH_FULLBAND));
-    opus_encoder_ctl(_enc, OPUS_SET_PACKET_LOSS_PERC(100));
+    opus_encoder_ctl(_enc, OPUS_SET_PACKET_LOSS_PERC(_opus_profile.packet_loss_perc));
     opus_encoder_ctl(_enc, OPUS_SET_PREDICTION_DISABLED(0));
     opus_encoder_ctl(_enc, OPUS_GET_BANDWIDTH(&opus_bandwidth));
-    opus_encoder_ctl(_enc, OPUS_SET_INBAND_FEC(0));
-    opus_decoder_ctl(_dec, OPUS_SET_GAIN(-3));
+    opus_encoder_ctl(_enc, OPUS_SET_INBAND_FEC(_opus_profile.fec ? 1 : 0));
+}
+
+const AudioEncoder::opus_profile &AudioEncoder::get_opus_profile() const
+{
+    return _opus_profile;
 }
 
 AudioEncoder::~AudioEncoder()
 {
     opus_encoder_destroy(_enc);
     opus_decoder_destroy(_dec);
-    codec2_destroy(_codec2);
-    codec2_destroy(_codec2_700);
+    opus_repacketizer_destroy(_repacketizer);
+    for(int i=0;i<gr_modem_types::Codec2ModeCount;i++)
+    {
+        if(_codec2[i])
+            codec2_destroy(_codec2[i]);
+    }
     gsm_destroy(_gsm);
 }
 
-unsigned char* AudioEncoder::encode_opus(short *audiobuffer, int audiobuffersize, int &encoded_size)
+int AudioEncoder::encode_opus(const short *audiobuffer, int audiobuffersize, unsigned char *encoded)
 {
-    unsigned char *encoded_audio = new unsigned char[47];
-    memset(encoded_audio,0,47);
-    encoded_size = opus_encode(_enc, audiobuffer, audiobuffersize/sizeof(short), encoded_audio, 47);
-    return encoded_audio;
-
+    memset(encoded,0,OpusMaxPacketBytes);
+    int encoded_size = opus_encode(_enc, audiobuffer, audiobuffersize/sizeof(short),
+                                   encoded, OpusMaxPacketBytes);
+    return encoded_size;
 }
 
-short* AudioEncoder::decode_opus(unsigned char *audiobuffer, int audiobuffersize, int &samples)
+int AudioEncoder::decode_opus(const unsigned char *audiobuffer, int audiobuffersize, short *pcm,
+                              int max_samples)
 {
-    int fs = 320;
-    short *pcm = new short[fs];
-    memset(pcm,0,(fs)*sizeof(short));
-    samples = opus_decode(_dec,audiobuffer,audiobuffersize, pcm, fs, 0);
+    int samples = opus_decode(_dec,audiobuffer,audiobuffersize, pcm, max_samples, 0);
     if(samples <= 0)
     {
-        delete[] pcm;
-        return NULL;
+        return 0;
     }
     hvdi::AGC(_agc,pcm,samples);
-    return pcm;
+    return samples;
 }
 
-unsigned char* AudioEncoder::encode_codec2(short *audiobuffer, int audiobuffersize, int &length)
+int AudioEncoder::decode_opus_fec(const unsigned char *next_packet, int data_length, short *pcm,
+                                  int missing_samples)
 {
-    Q_UNUSED(audiobuffersize);
-    int bits = codec2_bits_per_frame(_codec2);
-    //int bytes = (bits + 7) / 8;
-    int bytes = bits / 8;
-    unsigned char *encoded = new unsigned char[bytes];
-    codec2_encode(_codec2, encoded, audiobuffer);
-    length = bytes;
-    return encoded;
+    int samples = opus_decode(_dec,next_packet,data_length, pcm, missing_samples, 1);
+    if(samples <= 0)
+    {
+        return 0;
+    }
+    hvdi::AGC(_agc,pcm,samples);
+    return samples;
 }
 
-short* AudioEncoder::decode_codec2(unsigned char *audiobuffer, int audiobuffersize, int &samples)
+/// Grows a packet to a fixed frame size without changing the decoded audio
+int AudioEncoder::pad_opus(unsigned char *packet, int length, int padded_length)
 {
-    Q_UNUSED(audiobuffersize);
-    samples = codec2_samples_per_frame(_codec2);
-    short* decoded = new short[samples];
-    memset(decoded,0,(samples)*sizeof(short));
-    codec2_decode(_codec2, decoded, audiobuffer);
-    hvdi::AGC(_agc,decoded,samples);
-    return decoded;
+    if(length >= padded_length)
+        return length;
+    if(opus_packet_pad(packet, length, padded_length) != OPUS_OK)
+        return length;
+    return padded_length;
 }
 
-unsigned char* AudioEncoder::encode_codec2_700(short *audiobuffer, int audiobuffersize, int &length)
+/// Frames must share mode, bandwidth and duration, at most 120 ms in total
+int AudioEncoder::join_opus(const unsigned char * const *packets, const int *lengths, int count,
+                            unsigned char *joined, int max_length)
 {
-    Q_UNUSED(audiobuffersize);
-    int bits = codec2_bits_per_frame(_codec2_700);
-    int bytes = (bits + 4) / 8;
-    unsigned char *encoded = new unsigned char[bytes];
-    codec2_encode(_codec2_700, encoded, audiobuffer);
-    length = bytes;
-    return encoded;
+    opus_repacketizer_init(_repacketizer);
+    for(int i=0;i<count;i++)
+    {
+        if(opus_repacketizer_cat(_repacketizer, packets[i], lengths[i]) != OPUS_OK)
+            return 0;
+    }
+    int joined_size = opus_repacketizer_out(_repacketizer, joined, max_length);
+    if(joined_size < 0)
+        return 0;
+    return joined_size;
 }
 
-short* AudioEncoder::decode_codec2_700(unsigned char *audiobuffer, int audiobuffersize, int &samples)
+/// Codec2 states are created on first use, so only the modes in use cost memory
+struct CODEC2 *AudioEncoder::codec2State(int codec2_mode)
 {
-    Q_UNUSED(audiobuffersize);
-    samples = codec2_samples_per_frame(_codec2_700);
-    short* decoded = new short[samples];
-    memset(decoded,0,(samples)*sizeof(short));
-    codec2_decode(_codec2_700, decoded, audiobuffer);
-    hvdi::AGC(_agc,decoded,samples);
-    return decoded;
+    if((codec2_mode < 0) || (codec2_mode >= gr_modem_types::Codec2ModeCount))
+        return 0;
+    if(_codec2[codec2_mode])
+        return _codec2[codec2_mode];
+    int library_mode;
+    switch(codec2_mode)
+    {
+    case gr_modem_types::Codec2Mode3200:
+        library_mode = CODEC2_MODE_3200;
+        break;
+    case gr_modem_types::Codec2Mode2400:
+        library_mode = CODEC2_MODE_2400;
+        break;
+    case gr_modem_types::Codec2Mode1600:
+        library_mode = CODEC2_MODE_1600;
+        break;
+    case gr_modem_types::Codec2Mode1300:
+        library_mode = CODEC2_MODE_1300;
+        break;
+    case gr_modem_types::Codec2Mode700B:
+        library_mode = CODEC2_MODE_700B;
+        break;
+    case gr_modem_types::Codec2Mode700C:
+#ifdef CODEC2_MODE_700C
+        library_mode = CODEC2_MODE_700C;
+        break;
+#else
+        qDebug() << "Codec2 700C is not supported by this libcodec2";
+        return 0;
+#endif
+    default:
+        library_mode = CODEC2_MODE_1400;
+        break;
+    }
+    struct CODEC2 *state = codec2_create(library_mode);
+    const gr_modem_types::codec2_mode_info *info = gr_modem_types::get_codec2_mode_info(codec2_mode);
+    if((codec2_samples_per_frame(state) != info->frame_samples)
+            || (codec2_bits_per_frame(state) != info->frame_bits))
+        qDebug() << "unexpected Codec2 frame size for mode " << info->bitrate;
+    _codec2[codec2_mode] = state;
+    return state;
 }
 
-unsigned char* AudioEncoder::encode_gsm(short *audiobuffer, int audiobuffersize, int &length)
+int AudioEncoder::encode_codec2(const short *audiobuffer, int audiobuffersize, unsigned char *encoded,
+                                int codec2_mode)
 {
-    length = sizeof(gsm_frame);
-    unsigned char *encoded = new unsigned char[length];
-    gsm_encode(_gsm,audiobuffer,encoded);
-    return encoded;
+    struct CODEC2 *state = codec2State(codec2_mode);
+    if(!state)
+        return 0;
+    const gr_modem_types::codec2_mode_info *info = gr_modem_types::get_codec2_mode_info(codec2_mode);
+    int frame_bytes = (info->frame_bits + 7) / 8;
+    int frames = (audiobuffersize / (int)sizeof(short)) / info->frame_samples;
+    for(int i=0;i<frames;i++)
+    {
+        codec2_encode(state, encoded + i * frame_bytes,
+                      const_cast<short*>(audiobuffer) + i * info->frame_samples);
+    }
+    return frames * frame_bytes;
 }
 
-short* AudioEncoder::decode_gsm(unsigned char *audiobuffer, int data_length, int &samples)
+int AudioEncoder::decode_codec2(const unsigned char *audiobuffer, int audiobuffersize, short *pcm,
+                                int codec2_mode)
 {
-    samples = 160;
-    short* decoded = new short[160];
-    gsm_decode(_gsm,audiobuffer,decoded);
-    return decoded;
+    struct CODEC2 *state = codec2State(codec2_mode);
+    if(!state)
+        return 0;
+    const gr_modem_types::codec2_mode_info *info = gr_modem_types::get_codec2_mode_info(codec2_mode);
+    int frame_bytes = (info->frame_bits + 7) / 8;
+    int frames = std::min(audiobuffersize / frame_bytes, MaxFrameSamples / info->frame_samples);
+    for(int i=0;i<frames;i++)
+    {
+        codec2_decode(state, pcm + i * info->frame_samples, audiobuffer + i * frame_bytes);
+    }
+    int samples = frames * info->frame_samples;
+    hvdi::AGC(_agc,pcm,samples);
+    return samples;
 }
 
+int AudioEncoder::encode_gsm(const short *audiobuffer, int audiobuffersize, unsigned char *encoded)
+{
+    Q_UNUSED(audiobuffersize);
+    gsm_encode(_gsm,const_cast<short*>(audiobuffer),encoded);
+    return GSMFrameBytes;
+}
 
+int AudioEncoder::decode_gsm(const unsigned char *audiobuffer, int data_length, short *pcm)
+{
+    Q_UNUSED(data_length);
+    gsm_decode(_gsm,const_cast<unsigned char*>(audiobuffer),pcm);
+    return GSMFrameSamples;
+}
@@ -22,29 +22,83 @@
 #include <codec2/codec2.h>
 #include <gsm/gsm.h>
 #include "ext/agc.h"
+#include "gr/modem_types.h"
 
 class AudioEncoder
 {
 public:
+    /**
+     * Frame geometry of the configured codec modes. Callers size their
+     * buffers from these, so no per frame allocation is needed.
+     * Codec2 geometry comes from the table in modem_types.h.
+     */
+    enum
+    {
+        OpusFrameSamples = 320, // 40 ms @ 8 kHz
+        OpusMaxPacketBytes = 47, // 9400 bps CBR
+        GSMFrameSamples = 160,
+        GSMFrameBytes = 33,
+        MaxFrameSamples = 320,
+        MaxFrameBytes = 47,
+        OpusMaxPacketSamples = 960 // 120 ms, longest multi-frame packet
+    };
+
+    /// Opus encoder presets, selected per deployment with the opus_profile setting
+    enum
+    {
+        OpusProfileQuality, // CBR, full complexity, no FEC or DTX
+        OpusProfileResilient, // in-band FEC and DTX for lossy links
+        OpusProfileLowCPU, // reduced complexity and DTX for small boards
+        OpusProfileCount
+    };
+
+    struct opus_profile
+    {
+        int bitrate;
+        int complexity;
+        bool vbr;
+        bool fec;
+        bool dtx;
+        int packet_loss_perc;
+    };
+
     AudioEncoder();
     ~AudioEncoder();
-    unsigned char *encode_opus(short *audiobuffer, int audiobuffersize, int &encoded_size);
-    short *decode_opus(unsigned char *audiobuffer, int data_length, int &samples);
-    unsigned char* encode_codec2(short *audiobuffer, int audiobuffersize, int &length);
-    short* decode_codec2(unsigned char *audiobuffer, int audiobuffersize, int &samples);
-    unsigned char* encode_codec2_700(short *audiobuffer, int audiobuffersize, int &length);
-    short* decode_codec2_700(unsigned char *audiobuffer, int audiobuffersize, int &samples);
-    unsigned char* encode_gsm(short *audiobuffer, int audiobuffersize, int &length);
-    short* decode_gsm(unsigned char *audiobuffer, int data_length, int &samples);
+    // negative values keep the preset value
+    void set_opus_profile(int profile, int bitrate=-1, int complexity=-1, int packet_loss_perc=-1);
+    const opus_profile &get_opus_profile() const;
+    // encoders return the packet length, decoders the number of samples written
+    // decode_opus with a NULL buffer returns a concealment frame for a lost packet
+    int encode_opus(const short *audiobuffer, int audiobuffersize, unsigned char *encoded);
+    int decode_opus(const unsigned char *audiobuffer, int data_length, short *pcm,
+                    int max_samples=OpusFrameSamples);
+    // recovers a lost frame from the FEC data carried by the packet that follows it,
+    // missing_samples longer than one frame are concealed up to the recovered frame
+    int decode_opus_fec(const unsigned char *next_packet, int data_length, short *pcm,
+                        int missing_samples=OpusFrameSamples);
+    int pad_opus(unsigned char *packet, int length, int padded_length);
+    // joins single frame packets into one multi-frame packet, 0 if they can not be joined
+    int join_opus(const unsigned char * const *packets, const int *lengths, int count,
+                  unsigned char *joined, int max_length);
+    // a voice block of 320 samples may hold several 20 ms Codec2 frames
+    int encode_codec2(const short *audiobuffer, int audiobuffersize, unsigned char *encoded,
+                      int codec2_mode=gr_modem_types::Codec2Mode1400);
+    int decode_codec2(const unsigned char *audiobuffer, int audiobuffersize, short *pcm,
+                      int codec2_mode=gr_modem_types::Codec2Mode1400);
+    int encode_gsm(const short *audiobuffer, int audiobuffersize, unsigned char *encoded);
+    int decode_gsm(const unsigned char *audiobuffer, int data_length, short *pcm);
 
 
 private:
     OpusEncoder *_enc;
     OpusDecoder *_dec;
-    struct CODEC2 *_codec2;
-    struct CODEC2 *_codec2_700;
+    OpusRepacketizer *_repacketizer;
+    struct CODEC2 *codec2State(int codec2_mode);
+
+    struct CODEC2 *_codec2[gr_modem_types::Codec2ModeCount];
     struct gsm_state *_gsm;
     hvdi::agc_st *_agc;
+    opus_profile _opus_profile;
 };
 
 #endif // AUDIOENCODER_H
@@ -0,0 +1,211 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#include "dtmfdetector.h"
+#include <math.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <xmmintrin.h>
+#endif
+
+static const float dtmf_tones[DtmfDetector::Tones] =
+{
+    697, 770, 852, 941, 1209, 1336, 1477, 1633
+};
+
+static const char dtmf_keys[4][4] =
+{
+    {'1', '2', '3', 'A'},
+    {'4', '5', '6', 'B'},
+    {'7', '8', '9', 'C'},
+    {'*', '0', '#', 'D'}
+};
+
+DtmfDetector::DtmfDetector(int samp_rate, int block_size)
+{
+    _block_size = block_size;
+    for(int i=0;i<Tones;i++)
+    {
+        _coef[i] = 2.0f * cosf(2.0f * M_PI * dtmf_tones[i] / samp_rate);
+        _coef[Tones + i] = 2.0f * cosf(2.0f * M_PI * 2.0f * dtmf_tones[i] / samp_rate);
+    }
+    // the 697, 770 and 852 Hz harmonics lie within two bins of a column
+    // tone once both are allowed their 1.5% frequency tolerance
+    float bin = (float)samp_rate / block_size;
+    for(int i=0;i<Tones;i++)
+    {
+        float harmonic = 2.0f * dtmf_tones[i];
+        _harmonic_check[i] = true;
+        for(int j=0;j<Tones;j++)
+        {
+            float spacing = 2.0f * bin + 0.015f * (harmonic + dtmf_tones[j]);
+            if(fabsf(harmonic - dtmf_tones[j]) < spacing)
+                _harmonic_check[i] = false;
+        }
+    }
+    setThreshold(0.05f);
+    setToneDifference(6.0f);
+    setTwist(8.0f);
+    setHarmonicRejection(10.0f);
+    reset();
+}
+
+void DtmfDetector::reset()
+{
+    memset(_q1, 0, sizeof(_q1));
+    memset(_q2, 0, sizeof(_q2));
+    for(int p=0;p<Phases;p++)
+    {
+        _energy[p] = 0.0f;
+        // later phases start their first block one hop after the previous one
+        _count[p] = -p * hop();
+    }
+}
+
+/// Minimum peak amplitude of each tone, full scale is 1.0
+void DtmfDetector::setThreshold(float amplitude)
+{
+    float magnitude = amplitude * _block_size / 2.0f;
+    _min_power = magnitude * magnitude;
+}
+
+/// How much the detected tone must exceed the other tones of its group
+void DtmfDetector::setToneDifference(float db)
+{
+    _tone_ratio = powf(10.0f, db / 10.0f);
+}
+
+/// Largest level difference allowed between the row and the column tone
+void DtmfDetector::setTwist(float db)
+{
+    _twist_ratio = powf(10.0f, db / 10.0f);
+}
+
+/// How far below each tone its second harmonic must be
+void DtmfDetector::setHarmonicRejection(float db)
+{
+    _harmonic_ratio = powf(10.0f, db / 10.0f);
+}
+
+int DtmfDetector::hop() const
+{
+    return _block_size / Phases;
+}
+
+/**
+ * Feeds samples to the filter bank and writes one key, or ' ' when no
+ * valid digit is present, for each block which ends within them.
+ * Returns the number of keys written.
+ */
+int DtmfDetector::process(const float *samples, int count, char *keys, int max_keys)
+{
+    int decided = 0;
+    for(int i=0;i<count;i++)
+    {
+        float sample = samples[i];
+        if(sample > 1.0f)
+            sample = 1.0f;
+        else if(sample < -1.0f)
+            sample = -1.0f;
+        else if(sample != sample)
+            sample = 0.0f;
+        for(int p=0;p<Phases;p++)
+        {
+            if(_count[p] < 0)
+            {
+                _count[p]++;
+                continue;
+            }
+            update(p, sample);
+            if(++_count[p] < _block_size)
+                continue;
+            char key = decide(p);
+            if(decided < max_keys)
+                keys[decided++] = key;
+            memset(_q1[p], 0, sizeof(_q1[p]));
+            memset(_q2[p], 0, sizeof(_q2[p]));
+            _energy[p] = 0.0f;
+            _count[p] = 0;
+        }
+    }
+    return decided;
+}
+
+void DtmfDetector::update(int phase, float sample)
+{
+    float *q1 = _q1[phase];
+    float *q2 = _q2[phase];
+    int i = 0;
+#ifdef __SSE2__
+    __m128 x = _mm_set1_ps(sample);
+    for(;i + 4 <= Filters;i += 4)
+    {
+        __m128 c = _mm_loadu_ps(_coef + i);
+        __m128 a = _mm_loadu_ps(q1 + i);
+        __m128 b = _mm_loadu_ps(q2 + i);
+        _mm_storeu_ps(q2 + i, a);
+        _mm_storeu_ps(q1 + i, _mm_add_ps(_mm_sub_ps(_mm_mul_ps(c, a), b), x));
+    }
+#endif
+    for(;i < Filters;i++)
+    {
+        float q0 = _coef[i] * q1[i] - q2[i] + sample;
+        q2[i] = q1[i];
+        q1[i] = q0;
+    }
+    _energy[phase] += sample * sample;
+}
+
+char DtmfDetector::decide(int phase)
+{
+    const float *q1 = _q1[phase];
+    const float *q2 = _q2[phase];
+    float power[Filters];
+    for(int i=0;i<Filters;i++)
+        power[i] = q1[i] * q1[i] + q2[i] * q2[i] - _coef[i] * q1[i] * q2[i];
+
+    int row = 0;
+    int col = 4;
+    for(int i=1;i<4;i++)
+    {
+        if(power[i] > power[row])
+            row = i;
+        if(power[4 + i] > power[col])
+            col = 4 + i;
+    }
+    float row_power = power[row];
+    float col_power = power[col];
+    if((row_power < _min_power) || (col_power < _min_power))
+        return ' ';
+    if((row_power > col_power * _twist_ratio) || (col_power > row_power * _twist_ratio))
+        return ' ';
+    for(int i=0;i<4;i++)
+    {
+        if((i != row) && (power[i] * _tone_ratio > row_power))
+            return ' ';
+        if((4 + i != col) && (power[4 + i] * _tone_ratio > col_power))
+            return ' ';
+    }
+    // voice reaching these levels has strong harmonics, DTMF has none
+    if((_harmonic_check[row] && (power[Tones + row] * _harmonic_ratio > row_power)) ||
+            (_harmonic_check[col] && (power[Tones + col] * _harmonic_ratio > col_power)))
+        return ' ';
+    // the two tones must carry most of the block energy
+    if(2.0f * (row_power + col_power) < 0.5f * _block_size * _energy[phase])
+        return ' ';
+    return dtmf_keys[row][col - 4];
+}
@@ -0,0 +1,68 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#ifndef DTMFDETECTOR_H
+#define DTMFDETECTOR_H
+
+/**
+ * @brief Goertzel filter bank decoding DTMF keys from 8 kHz audio.
+ *
+ * The four row and four column tones and their second harmonics are
+ * sixteen Goertzel filters updated together, four at a time with SSE,
+ * in a single pass over each sample. A harmonic which can fall next to
+ * another DTMF tone picks up that tone's leakage and is not checked.
+ * Two sets of filter states run half a block apart, so a block
+ * overlapping the previous one by half ends every hop() samples. All
+ * state lives in the object, one detector per audio channel.
+ */
+class DtmfDetector
+{
+public:
+    enum
+    {
+        Tones = 8, // rows then columns
+        Filters = 16, // tones then their second harmonics
+        Phases = 2
+    };
+
+    DtmfDetector(int samp_rate = 8000, int block_size = 204);
+    void reset();
+    void setThreshold(float amplitude);
+    void setToneDifference(float db);
+    void setTwist(float db);
+    void setHarmonicRejection(float db);
+    int process(const float *samples, int count, char *keys, int max_keys);
+    int hop() const;
+
+private:
+    void update(int phase, float sample);
+    char decide(int phase);
+
+    float _coef[Filters];
+    bool _harmonic_check[Tones];
+    float _q1[Phases][Filters];
+    float _q2[Phases][Filters];
+    float _energy[Phases];
+    int _count[Phases];
+    int _block_size;
+    float _min_power;
+    float _tone_ratio;
+    float _twist_ratio;
+    float _harmonic_ratio;
+};
+
+#endif // DTMFDETECTOR_H
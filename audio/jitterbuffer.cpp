@@ -0,0 +1,188 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "jitterbuffer.h"
+#include <math.h>
+#include <algorithm>
+
+JitterBuffer::JitterBuffer(int frame_period_ms, int max_depth, int max_concealed)
+{
+    _frame_period = frame_period_ms;
+    _max_depth = max_depth;
+    _base_max_depth = max_depth;
+    _burst_frames = 1;
+    _min_depth = 1;
+    _max_concealed = max_concealed;
+    reset();
+}
+
+void JitterBuffer::reset()
+{
+    _frames.clear();
+    _target_depth = _min_depth;
+    _concealed = 0;
+    _underruns = 0;
+    _playing = false;
+    _end_of_stream = false;
+    _jitter = 0;
+    _last_arrival = -1;
+    _next_playout = 0;
+}
+
+/// Number of frames which arrive together in one radio frame
+void JitterBuffer::setBurstFrames(int frames)
+{
+    _burst_frames = std::max(1, frames);
+    // room for a whole burst on top of the jitter depth
+    _max_depth = std::max(_base_max_depth, 2 * _burst_frames + 4);
+}
+
+/// Frames held back at least, 2 keeps the next frame at hand for FEC recovery
+void JitterBuffer::setMinDepth(int frames)
+{
+    _min_depth = std::max(1, std::min(_max_depth / 2, frames));
+    _target_depth = std::max(_target_depth, _min_depth);
+}
+
+void JitterBuffer::put(const ByteFrame &frame, qint64 arrival_ms)
+{
+    qint64 stamp = arrival_ms;
+    if(_last_arrival >= 0)
+    {
+        // frames of one burst, or early ones, are due one period after the previous frame
+        stamp = std::max(arrival_ms, _last_arrival + _frame_period);
+        qint64 interval = stamp - _last_arrival;
+        if(interval < 10 * _frame_period)
+        {
+            // a gap well beyond the jitter means frames were lost on the air,
+            // queue a marker for each so the next frame can recover the last one
+            int missing = 0;
+            if(interval > (3 * _frame_period) / 2 + (qint64)(2.0f * _jitter))
+                missing = std::min(_max_concealed,
+                                   (int)((interval + _frame_period / 2) / _frame_period) - 1);
+            // frames already concealed while the queue ran dry are not lost again
+            for(int i=_underruns;i<missing;i++)
+                push(ByteFrame());
+            // smoothed deviation of the arrival interval from the frame period, as in RFC 3550
+            float deviation = fabs((float)(interval - (missing + 1) * _frame_period));
+            _jitter += (deviation - _jitter) / 16.0f;
+            updateTargetDepth();
+        }
+    }
+    _last_arrival = stamp;
+    _underruns = 0;
+    _end_of_stream = false;
+    push(frame);
+}
+
+void JitterBuffer::push(const ByteFrame &frame)
+{
+    if((int)_frames.size() >= _max_depth)
+        _frames.pop_front();
+    _frames.push_back(frame);
+}
+
+void JitterBuffer::updateTargetDepth()
+{
+    int depth = (int)ceil(2.0f * _jitter / _frame_period) + 1;
+    _target_depth = std::max(_min_depth, std::min(_max_depth / 2, depth));
+}
+
+int JitterBuffer::get(ByteFrame &frame, qint64 now_ms)
+{
+    if(!_playing)
+    {
+        if(_frames.empty())
+            return FrameWaiting;
+        if(((int)_frames.size() < _target_depth) && !_end_of_stream)
+            return FrameWaiting;
+        _playing = true;
+        _concealed = 0;
+        _next_playout = now_ms;
+    }
+    if(now_ms < _next_playout)
+        return FrameWaiting;
+    // never try to catch up more than one period after a stall
+    if(now_ms - _next_playout > _frame_period)
+        _next_playout = now_ms;
+    _next_playout += _frame_period;
+
+    if(_frames.empty())
+    {
+        _concealed++;
+        if(_end_of_stream || (_concealed > _max_concealed))
+        {
+            // talk spurt over or link gone, rebuffer before playing again
+            _playing = false;
+            return FrameWaiting;
+        }
+        _underruns++;
+        return FrameLost;
+    }
+    // latency grew beyond what the jitter and a burst need, skip a frame to shrink it
+    if((int)_frames.size() > _target_depth + _burst_frames + 1)
+        _frames.pop_front();
+    frame = _frames.front();
+    _frames.pop_front();
+    if(frame.isNull())
+    {
+        // known loss with later frames queued
+        _concealed++;
+        return FrameLost;
+    }
+    _concealed = 0;
+    return FrameReady;
+}
+
+/// The frame that will be played next, used to recover a lost frame from its FEC data
+bool JitterBuffer::peek(ByteFrame &frame) const
+{
+    if(_frames.empty() || _frames.front().isNull())
+        return false;
+    frame = _frames.front();
+    return true;
+}
+
+/// No more frames are expected, drain the queue without concealing the tail
+void JitterBuffer::endOfStream()
+{
+    _end_of_stream = true;
+}
+
+int JitterBuffer::size() const
+{
+    return _frames.size();
+}
+
+int JitterBuffer::targetDepth() const
+{
+    return _target_depth;
+}
+
+float JitterBuffer::jitter() const
+{
+    return _jitter;
+}
+
+int JitterBuffer::concealedFrames() const
+{
+    return _concealed;
+}
+
+int JitterBuffer::maxConcealed() const
+{
+    return _max_concealed;
+}
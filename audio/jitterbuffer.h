@@ -0,0 +1,86 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef JITTERBUFFER_H
+#define JITTERBUFFER_H
+
+#include <QtGlobal>
+#include <deque>
+#include "ext/framebuffer.h"
+
+/**
+ * @brief Playout buffer for received voice frames.
+ *
+ * Radio frames carry no sequence numbers, so the buffer works on arrival
+ * times. It measures the interarrival jitter against the nominal frame
+ * period and holds back as many frames as that jitter requires before
+ * starting playout. Once playing, get() hands out one frame per period
+ * and reports a lost frame when the queue runs dry, or when an arrival
+ * gap showed that frames are missing, so the caller can conceal it. In
+ * the second case peek() returns the frame after the gap, which can carry
+ * FEC data for the lost one.
+ *
+ * A Codec2 superframe delivers several frames at once. Frames arriving
+ * within one period of the previous one are stamped a period after it,
+ * so a burst counts as frames spaced one period apart and only late
+ * arrivals add jitter. The depth limits grow with the burst size.
+ */
+class JitterBuffer
+{
+public:
+    enum
+    {
+        FrameWaiting,
+        FrameReady,
+        FrameLost
+    };
+
+    JitterBuffer(int frame_period_ms = 40, int max_depth = 12, int max_concealed = 3);
+    void setBurstFrames(int frames);
+    void setMinDepth(int frames);
+    void put(const ByteFrame &frame, qint64 arrival_ms);
+    int get(ByteFrame &frame, qint64 now_ms);
+    bool peek(ByteFrame &frame) const;
+    void endOfStream();
+    void reset();
+    int size() const;
+    int targetDepth() const;
+    float jitter() const;
+    int concealedFrames() const;
+    int maxConcealed() const;
+
+private:
+    void updateTargetDepth();
+    void push(const ByteFrame &frame);
+
+    std::deque<ByteFrame> _frames;
+    int _frame_period;
+    int _max_depth;
+    int _base_max_depth;
+    int _burst_frames;
+    int _min_depth;
+    int _max_concealed;
+    int _target_depth;
+    int _concealed;
+    int _underruns;
+    bool _playing;
+    bool _end_of_stream;
+    float _jitter;
+    qint64 _last_arrival;
+    qint64 _next_playout;
+};
+
+#endif // JITTERBUFFER_H
@@ -0,0 +1,191 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "transcoder.h"
+
+Transcoder::Transcoder(Settings *settings, QObject *parent) :
+    QObject(parent)
+{
+    _codec = new AudioEncoder;
+    _codec->set_opus_profile(settings->_opus_profile, settings->_opus_bitrate,
+                             settings->_opus_complexity, settings->_opus_packet_loss);
+    _pcm.reserve(MaxLatencyMs * 8 + AudioEncoder::OpusMaxPacketSamples);
+    _rx_codec = gr_modem_types::CodecNone;
+    _tx_codec = gr_modem_types::CodecNone;
+    _rx_codec2_mode = gr_modem_types::Codec2Mode1400;
+    _tx_codec2_mode = gr_modem_types::Codec2Mode1400;
+    for(int i=0;i<4;i++)
+        _pending_modes[i] = 0;
+}
+
+Transcoder::~Transcoder()
+{
+    delete _codec;
+}
+
+void Transcoder::setModes(int rx_mode, int rx_codec2_mode, int tx_mode, int tx_codec2_mode)
+{
+    _mutex.lock();
+    _pending_modes[0] = rx_mode;
+    _pending_modes[1] = rx_codec2_mode;
+    _pending_modes[2] = tx_mode;
+    _pending_modes[3] = tx_codec2_mode;
+    _mutex.unlock();
+    _modes_changed.fetchAndStoreRelease(1);
+}
+
+bool Transcoder::putEncoded(const ByteFrame &frame)
+{
+    if(_in_encoded.push(frame))
+        return true;
+    _dropped.fetchAndAddAcquire(1);
+    return false;
+}
+
+bool Transcoder::putAudio(const FloatFrame &audio)
+{
+    if(_in_audio.push(audio))
+        return true;
+    _dropped.fetchAndAddAcquire(1);
+    return false;
+}
+
+bool Transcoder::getEncoded(ByteFrame &frame)
+{
+    return _out_encoded.pop(frame);
+}
+
+bool Transcoder::getAudio(FloatFrame &audio)
+{
+    return _out_audio.pop(audio);
+}
+
+/// Frames lost to full queues or to the latency cap
+int Transcoder::dropped()
+{
+    return _dropped.fetchAndAddAcquire(0);
+}
+
+void Transcoder::stop()
+{
+    _stop.fetchAndStoreRelease(1);
+}
+
+void Transcoder::run()
+{
+    while(!_stop.fetchAndAddAcquire(0))
+    {
+        if(_modes_changed.fetchAndStoreAcquire(0))
+            applyModes();
+        bool idle = true;
+        ByteFrame frame;
+        while(_in_encoded.pop(frame))
+        {
+            decode(frame);
+            idle = false;
+        }
+        FloatFrame audio;
+        while(_in_audio.pop(audio))
+        {
+            const float *in = audio.constData();
+            for(int i=0;i<audio.size();i++)
+                _pcm.push_back((short)(qBound(-1.0f, in[i], 1.0f) * 32767.0f));
+            idle = false;
+        }
+        // keep the backlog bounded, the oldest audio goes first
+        int max_samples = MaxLatencyMs * 8;
+        if(_pcm.size() > max_samples)
+        {
+            _pcm.remove(0, _pcm.size() - max_samples);
+            _dropped.fetchAndAddAcquire(1);
+        }
+        encodeBlocks();
+        if(idle)
+            usleep(2000);
+    }
+    emit finished();
+}
+
+void Transcoder::applyModes()
+{
+    _mutex.lock();
+    const gr_modem_types::modem_info *rx = gr_modem_types::get_modem_info(_pending_modes[0]);
+    const gr_modem_types::modem_info *tx = gr_modem_types::get_modem_info(_pending_modes[2]);
+    _rx_codec2_mode = _pending_modes[1];
+    _tx_codec2_mode = _pending_modes[3];
+    _mutex.unlock();
+    _rx_codec = rx ? rx->codec : gr_modem_types::CodecNone;
+    _tx_codec = tx ? tx->codec : gr_modem_types::CodecNone;
+    _in_encoded.clear();
+    _in_audio.clear();
+    _pcm.clear();
+}
+
+void Transcoder::decode(const ByteFrame &frame)
+{
+    short pcm[AudioEncoder::OpusMaxPacketSamples];
+    int samples = 0;
+    if(_rx_codec == gr_modem_types::CodecCodec2)
+        samples = _codec->decode_codec2(frame.constData(), frame.size(), pcm, _rx_codec2_mode);
+    else if(_rx_codec == gr_modem_types::CodecOpus)
+        samples = _codec->decode_opus(frame.constData(), frame.size(), pcm,
+                                      AudioEncoder::OpusMaxPacketSamples);
+    for(int i=0;i<samples;i++)
+        _pcm.push_back(pcm[i]);
+}
+
+void Transcoder::encodeBlocks()
+{
+    const int block = gr_modem_types::VoiceBlockSamples;
+    while(_pcm.size() >= block)
+    {
+        const short *in = _pcm.constData();
+        if(_tx_codec == gr_modem_types::CodecNone)
+        {
+            FloatFrame audio(block);
+            float *out = audio.data();
+            for(int i=0;i<block;i++)
+                out[i] = (float)in[i] / 32767.0f;
+            if(!_out_audio.push(audio))
+                _dropped.fetchAndAddAcquire(1);
+        }
+        else
+        {
+            ByteFrame encoded(AudioEncoder::MaxFrameBytes);
+            int size = 0;
+            if(_tx_codec == gr_modem_types::CodecCodec2)
+            {
+                size = _codec->encode_codec2(in, block * sizeof(short), encoded.data(), _tx_codec2_mode);
+            }
+            else
+            {
+                size = _codec->encode_opus(in, block * sizeof(short), encoded.data());
+                // DTX packets carry only silence, radio frames have a fixed length
+                if(size <= 2)
+                    size = 0;
+                else
+                    size = _codec->pad_opus(encoded.data(), size, AudioEncoder::OpusMaxPacketBytes);
+            }
+            if(size > 0)
+            {
+                encoded.resize(size);
+                if(!_out_encoded.push(encoded))
+                    _dropped.fetchAndAddAcquire(1);
+            }
+        }
+        _pcm.remove(0, block);
+    }
+}
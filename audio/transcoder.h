@@ -0,0 +1,93 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef TRANSCODER_H
+#define TRANSCODER_H
+
+#include <QObject>
+#include <QVector>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QDebug>
+#include <unistd.h>
+#include "audio/audioencoder.h"
+#include "ext/framebuffer.h"
+#include "ext/spscqueue.h"
+#include "gr/modem_types.h"
+#include "settings.h"
+
+/**
+ * @brief Voice transcoder for cross mode repeating, running on its own thread.
+ *
+ * The radio thread queues received vocoder frames or analog audio. The
+ * worker decodes them to 8 kHz PCM, reblocks it into 40 ms voice blocks and
+ * encodes them for the TX mode, or converts them to float audio for an
+ * analog TX mode. The radio thread then picks up the results. All queues
+ * are bounded and the PCM backlog is capped at MaxLatencyMs, so a stalled
+ * side loses audio instead of building up delay.
+ */
+class Transcoder : public QObject
+{
+    Q_OBJECT
+public:
+    enum
+    {
+        MaxLatencyMs = 200,
+        QueueFrames = 16
+    };
+
+    explicit Transcoder(Settings *settings, QObject *parent = 0);
+    ~Transcoder();
+
+    // codec2 modes are ignored for modems without a Codec2 vocoder
+    void setModes(int rx_mode, int rx_codec2_mode, int tx_mode, int tx_codec2_mode);
+    // radio thread side
+    bool putEncoded(const ByteFrame &frame);
+    bool putAudio(const FloatFrame &audio);
+    bool getEncoded(ByteFrame &frame);
+    bool getAudio(FloatFrame &audio);
+    int dropped();
+
+signals:
+    void finished();
+
+public slots:
+    void run();
+    void stop();
+
+private:
+    void applyModes();
+    void decode(const ByteFrame &frame);
+    void encodeBlocks();
+
+    AudioEncoder *_codec;
+    SpscQueue<ByteFrame, QueueFrames> _in_encoded;
+    SpscQueue<FloatFrame, QueueFrames> _in_audio;
+    SpscQueue<ByteFrame, QueueFrames> _out_encoded;
+    SpscQueue<FloatFrame, QueueFrames> _out_audio;
+    QVector<short> _pcm;
+    QMutex _mutex;
+    int _pending_modes[4];
+    QAtomicInt _modes_changed;
+    QAtomicInt _stop;
+    QAtomicInt _dropped;
+    int _rx_codec;
+    int _rx_codec2_mode;
+    int _tx_codec;
+    int _tx_codec2_mode;
+};
+
+#endif // TRANSCODER_H
@@ -0,0 +1,132 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "voipmixer.h"
+#include <string.h>
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+VoipMixer::VoipMixer(int prebuffer_ms, int max_depth_ms)
+{
+    _prebuffer_samples = prebuffer_ms * BlockSamples / BlockMs;
+    _max_samples = max_depth_ms * BlockSamples / BlockMs;
+}
+
+VoipMixer::~VoipMixer()
+{
+    reset();
+}
+
+void VoipMixer::put(quint64 session_id, const short *pcm, int samples)
+{
+    session_fifo *session = _sessions.value(session_id, 0);
+    if(!session)
+    {
+        session = new session_fifo;
+        session->playing = false;
+        session->waited_samples = 0;
+        _sessions.insert(session_id, session);
+    }
+    session->samples.insert(session->samples.end(), pcm, pcm + samples);
+    // drop the oldest audio so a burst can not build up latency
+    if(session->samples.size() > _max_samples)
+        session->samples.erase(session->samples.begin(),
+                               session->samples.begin() + (session->samples.size() - _max_samples));
+}
+
+/// Writes one block of BlockSamples, returns 0 when nobody is talking
+int VoipMixer::mix(short *out)
+{
+    short block[BlockSamples];
+    bool mixed = false;
+    memset(out, 0, BlockSamples * sizeof(short));
+    QMap<quint64, session_fifo*>::iterator it = _sessions.begin();
+    while(it != _sessions.end())
+    {
+        session_fifo *session = it.value();
+        if(!session->playing)
+        {
+            // start once the prebuffer is full, or a short burst has waited long enough
+            session->waited_samples += BlockSamples;
+            if((session->samples.size() >= _prebuffer_samples) ||
+                    (session->waited_samples >= _prebuffer_samples))
+                session->playing = true;
+        }
+        if(!session->playing)
+        {
+            ++it;
+            continue;
+        }
+        int samples = std::min((int)session->samples.size(), (int)BlockSamples);
+        std::copy(session->samples.begin(), session->samples.begin() + samples, block);
+        memset(block + samples, 0, (BlockSamples - samples) * sizeof(short));
+        session->samples.erase(session->samples.begin(), session->samples.begin() + samples);
+        addSaturated(out, block, BlockSamples);
+        mixed = true;
+        if(session->samples.empty())
+        {
+            // speaker stopped or starved, a new talk spurt prebuffers again
+            delete session;
+            it = _sessions.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return mixed ? BlockSamples : 0;
+}
+
+void VoipMixer::addSaturated(short *acc, const short *in, int samples)
+{
+    int i = 0;
+#ifdef __SSE2__
+    for(;i + 8 <= samples;i += 8)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), _mm_adds_epi16(a, b));
+    }
+#endif
+    for(;i < samples;i++)
+    {
+        int sum = (int)acc[i] + (int)in[i];
+        if(sum > 32767)
+            sum = 32767;
+        else if(sum < -32768)
+            sum = -32768;
+        acc[i] = (short)sum;
+    }
+}
+
+void VoipMixer::removeSession(quint64 session_id)
+{
+    session_fifo *session = _sessions.take(session_id);
+    delete session;
+}
+
+void VoipMixer::reset()
+{
+    qDeleteAll(_sessions);
+    _sessions.clear();
+}
+
+int VoipMixer::sessions() const
+{
+    return _sessions.size();
+}
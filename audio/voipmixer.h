@@ -0,0 +1,65 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef VOIPMIXER_H
+#define VOIPMIXER_H
+
+#include <QtGlobal>
+#include <QMap>
+#include <deque>
+
+/**
+ * @brief Mixes the voice of several VOIP speakers into one stream.
+ *
+ * Each session gets its own sample FIFO which is filled as decoded audio
+ * arrives and is held back until it reaches the prebuffer depth. mix()
+ * is driven by a fixed clock and takes one block from every playing
+ * session, summing them with saturation. A session that runs dry
+ * rebuffers on its own without stalling the others.
+ */
+class VoipMixer
+{
+public:
+    enum
+    {
+        BlockSamples = 160, // 20 ms @ 8 kHz
+        BlockMs = 20
+    };
+
+    VoipMixer(int prebuffer_ms = 60, int max_depth_ms = 240);
+    ~VoipMixer();
+    void put(quint64 session_id, const short *pcm, int samples);
+    int mix(short *out);
+    void removeSession(quint64 session_id);
+    void reset();
+    int sessions() const;
+
+private:
+    struct session_fifo
+    {
+        std::deque<short> samples;
+        bool playing;
+        unsigned int waited_samples; // clock time spent prebuffering
+    };
+
+    static void addSaturated(short *acc, const short *in, int samples);
+
+    QMap<quint64, session_fifo*> _sessions;
+    unsigned int _prebuffer_samples;
+    unsigned int _max_samples;
+};
+
+#endif // VOIPMIXER_H
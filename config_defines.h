@@ -15,11 +15,6 @@
 #define PROTOCOL_VERSION ((PROTVER_MAJOR << 16) | (PROTVER_MINOR << 8) | (PROTVER_PATCH))
 
 #define CONTROL_PORT 4939
-#ifdef LOCAL
-#define UDP_PORT 0 // multiple clients on local station can't bind to the same port
-#else
-#define UDP_PORT 4938
-#endif
 
 #define NUM_CALLS 4
 #define DEFAULT_SERVER ""
@@ -24,16 +24,6 @@ DtmfDecoder::DtmfDecoder(Settings *settings, QObject *parent) :
     QObject(parent)
 {
     _stop=false;
-    _dtmf_frequencies[0]= 697;
-    _dtmf_frequencies[1]= 770;
-    _dtmf_frequencies[2]= 852;
-    _dtmf_frequencies[3]= 941;
-    _dtmf_frequencies[4]= 1100;
-    _dtmf_frequencies[5]= 1209;
-    _dtmf_frequencies[6]= 1336;
-    _dtmf_frequencies[7]= 1477;
-    _dtmf_frequencies[8]= 1633;
-    _dtmf_frequencies[9]= 2500;
     _dtmf_sequence = new QVector<char>;
     _dtmf_command = new QVector<char>;
     _current_letter = ' ';
@@ -72,11 +62,14 @@ void DtmfDecoder::run()
 {
     float cw_tone_freq = 900.0;
     Q_UNUSED(cw_tone_freq);
-    int buffer_size = 512;
     int samp_rate = 8000;
-    float treshhold_audio_power = 100.0;
+    float treshhold_audio_level = 0.05; // tone amplitude, full scale is 1.0
     float tone_difference = 6.0; //dB
-    int analysis_buffer = 25;
+    int analysis_buffer = 8; // one letter per detector hop, 12.75 ms
+    _detector.setThreshold(treshhold_audio_level);
+    _detector.setToneDifference(tone_difference);
+    // one detector block ends with every read
+    int buffer_size = _detector.hop();
     char call_key='C';
     char call_direct_key='Q';
     char command_key='D';
@@ -95,11 +88,11 @@ void DtmfDecoder::run()
         float buf[buffer_size];
         memset(buf,0,buffer_size*sizeof(float));
 
-        audio->read(buf, buffer_size);
+        audio->read(buf, buffer_size*sizeof(float));
 
         char letter = '?';
 
-        letter = newDecode(buf,buffer_size,samp_rate, treshhold_audio_power, tone_difference);
+        letter = newDecode(buf,buffer_size);
 
         /** this function uses code with unknown license
         letter = decode(buf,buffer_size,samp_rate, treshhold_audio_power, tone_difference);
@@ -173,142 +166,13 @@ void DtmfDecoder::run()
     emit finished();
 }
 
-char DtmfDecoder::newDecode(float *buf,int buffer_size,int samp_rate, float treshhold_audio_power, float tone_difference)
+char DtmfDecoder::newDecode(float *buf,int buffer_size)
 {
-    Q_UNUSED(tone_difference);
-    int tones[2];
-    tones[0] = 0;
-    tones[1] = 0;
-    float largest_tone_power = 0.0;
-    for(int i=0;i<5;i++)
-    {
-        Goertzel gk(static_cast<float>(_dtmf_frequencies[i]), samp_rate);
-        for(int j=0;j<buffer_size;j++)
-        {
-            buf[j] = (buf[j] > 1.0) ? 0.0 : buf[j];
-            buf[j] = (buf[j] < -1.0) ? 0.0 : buf[j];
-            gk.calc(buf[j]);
-        }
-        float tone_power = gk.magnitudeSquared();
-        if(!std::isfinite(tone_power))
-        {
-            qDebug() << "infinite value";
-        }
-
-        if(tone_power != tone_power) continue; // no ffast-math here
-        if(tone_power < largest_tone_power) continue;
-        if(tone_power < treshhold_audio_power) continue;
-
-        tones[0] = _dtmf_frequencies[i];
-        largest_tone_power = tone_power;
-    }
-    largest_tone_power = 0.0;
-    for(int i=5;i<9;i++)
-    {
-        Goertzel gk(static_cast<float>(_dtmf_frequencies[i]), samp_rate);
-        for(int j=0;j<buffer_size;j++)
-        {
-            buf[j] = (buf[j] > 1.0) ? 0.0 : buf[j];
-            buf[j] = (buf[j] < -1.0) ? 0.0 : buf[j];
-            gk.calc(buf[j]);
-        }
-        float tone_power = gk.magnitudeSquared();
-        if(!std::isfinite(tone_power))
-        {
-            qDebug() << "infinite value";
-        }
-
-        if(tone_power != tone_power) continue; // no ffast-math here
-        if(tone_power < largest_tone_power) continue;
-        if(tone_power < treshhold_audio_power) continue;
-
-        tones[1] = _dtmf_frequencies[i];
-        largest_tone_power = tone_power;
-    }
-    char letter;
-    switch(tones[0])
-    {
-    case 697:
-        switch(tones[1])
-        {
-        case 1209:
-            letter = '1';
-            break;
-        case 1336:
-            letter = '2';
-            break;
-        case 1477:
-            letter = '3';
-            break;
-        case 1633:
-            letter = 'A';
-            break;
-        default:
-            letter = ' ';
-        }
-
-        break;
-    case 770:
-        switch(tones[1])
-        {
-        case 1209:
-            letter = '4';
-            break;
-        case 1336:
-            letter = '5';
-            break;
-        case 1477:
-            letter = '6';
-            break;
-        case 1633:
-            letter = 'B';
-            break;
-        default:
-            letter = ' ';
-        }
-        break;
-    case 852:
-        switch(tones[1])
-        {
-        case 1209:
-            letter = '7';
-            break;
-        case 1336:
-            letter = '8';
-            break;
-        case 1477:
-            letter = '9';
-            break;
-        case 1633:
-            letter = 'C';
-            break;
-        default:
-            letter = ' ';
-        }
-        break;
-    case 941:
-        switch(tones[1])
-        {
-        case 1209:
-            letter = '*';
-            break;
-        case 1336:
-            letter = '0';
-            break;
-        case 1477:
-            letter = '#';
-            break;
-        case 1633:
-            letter = 'D';
-            break;
-        default:
-            letter = ' ';
-        }
-        break;
-    default:
-        letter = ' ';
-    }
-    return letter;
+    char keys[DtmfDetector::Phases];
+    int decided = _detector.process(buf, buffer_size, keys, DtmfDetector::Phases);
+    if(decided < 1)
+        return ' ';
+    return keys[decided - 1];
 }
 
 void DtmfDecoder::analyse(int analysis_buffer)
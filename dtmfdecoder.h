@@ -26,7 +26,8 @@
 #include "speech.h"
 #include "config_defines.h"
 //#include "ext/goertzel.h" // Goertzel class below is GPL
-#include "ext/Goertzel.h"
+#include <cmath>
+#include "audio/dtmfdetector.h"
 #include "settings.h"
 
 class DtmfDecoder : public QObject
@@ -60,12 +61,12 @@ private:
      * @return
      */
     char decode(float *buf, int buffer_size, int samp_rate, float treshhold_audio_power, float tone_difference);
-    char newDecode(float *buf,int buffer_size,int samp_rate, float treshhold_audio_power, float tone_difference);
+    char newDecode(float *buf,int buffer_size);
     /**
      * @brief Statistical analysis of char buffer
      */
     void analyse(int analysis_buffer);
-    int _dtmf_frequencies[10];
+    DtmfDetector _detector;
     QVector<char> *_dtmf_sequence;
     QVector<char> *_dtmf_command;
     char _current_letter;
@@ -0,0 +1,270 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMetaType>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+/**
+ * @brief Size classed free lists of raw buffer blocks, one pool per item type.
+ *
+ * Blocks are recycled instead of freed, so once the voice and data paths
+ * have warmed up, handing frames between objects no longer touches the heap.
+ */
+template <typename T>
+class FrameBufferPool
+{
+public:
+    struct Block
+    {
+        QAtomicInt ref;
+        int size;
+        int capacity;
+        int size_class;
+        Block *next;
+        T *data;
+    };
+
+    static FrameBufferPool *instance()
+    {
+        static FrameBufferPool pool;
+        return &pool;
+    }
+
+    Block *acquire(int size)
+    {
+        int size_class = 0;
+        while((size_class < SIZE_CLASSES) && ((MIN_CAPACITY << size_class) < size))
+            size_class++;
+        Block *block = 0;
+        if(size_class < SIZE_CLASSES)
+        {
+            _mutex.lock();
+            block = _free[size_class];
+            if(block)
+            {
+                _free[size_class] = block->next;
+                _free_count[size_class]--;
+            }
+            _mutex.unlock();
+        }
+        if(!block)
+        {
+            int capacity = (size_class < SIZE_CLASSES) ? (MIN_CAPACITY << size_class) : size;
+            // header and items share one allocation
+            block = (Block*) malloc(sizeof(Block) + capacity * sizeof(T));
+            new (&block->ref) QAtomicInt(0);
+            block->capacity = capacity;
+            block->size_class = (size_class < SIZE_CLASSES) ? size_class : -1;
+            block->data = reinterpret_cast<T*>(block + 1);
+        }
+        block->ref.ref();
+        block->size = size;
+        block->next = 0;
+        return block;
+    }
+
+    void release(Block *block)
+    {
+        if(block->size_class >= 0)
+        {
+            _mutex.lock();
+            if(_free_count[block->size_class] < MAX_FREE)
+            {
+                block->next = _free[block->size_class];
+                _free[block->size_class] = block;
+                _free_count[block->size_class]++;
+                block = 0;
+            }
+            _mutex.unlock();
+        }
+        if(block)
+        {
+            block->ref.~QAtomicInt();
+            free(block);
+        }
+    }
+
+private:
+    enum
+    {
+        MIN_CAPACITY = 64,
+        SIZE_CLASSES = 12,
+        MAX_FREE = 64
+    };
+
+    FrameBufferPool()
+    {
+        for(int i=0;i<SIZE_CLASSES;i++)
+        {
+            _free[i] = 0;
+            _free_count[i] = 0;
+        }
+    }
+
+    ~FrameBufferPool()
+    {
+        for(int i=0;i<SIZE_CLASSES;i++)
+        {
+            while(_free[i])
+            {
+                Block *block = _free[i];
+                _free[i] = block->next;
+                block->ref.~QAtomicInt();
+                free(block);
+            }
+        }
+    }
+
+    QMutex _mutex;
+    Block *_free[SIZE_CLASSES];
+    int _free_count[SIZE_CLASSES];
+};
+
+/**
+ * @brief Reference counted handle to a pooled frame of POD items.
+ *
+ * Copying a FrameBuffer only increments the reference count, so frames can
+ * travel through queued signals by value without copying their contents.
+ * Producers fill the buffer before emitting it, after that all holders
+ * treat the contents as read only.
+ */
+template <typename T>
+class FrameBuffer
+{
+public:
+    typedef typename FrameBufferPool<T>::Block Block;
+
+    FrameBuffer() : _block(0) {}
+
+    explicit FrameBuffer(int size) : _block(0)
+    {
+        if(size > 0)
+            _block = FrameBufferPool<T>::instance()->acquire(size);
+    }
+
+    FrameBuffer(const T *data, int size) : _block(0)
+    {
+        if(size > 0)
+        {
+            _block = FrameBufferPool<T>::instance()->acquire(size);
+            memcpy(_block->data, data, size * sizeof(T));
+        }
+    }
+
+    FrameBuffer(const FrameBuffer &other) : _block(other._block)
+    {
+        if(_block)
+            _block->ref.ref();
+    }
+
+#if __cplusplus >= 201103L
+    FrameBuffer(FrameBuffer &&other) : _block(other._block)
+    {
+        other._block = 0;
+    }
+
+    FrameBuffer &operator=(FrameBuffer &&other)
+    {
+        if(this != &other)
+        {
+            release();
+            _block = other._block;
+            other._block = 0;
+        }
+        return *this;
+    }
+#endif
+
+    ~FrameBuffer()
+    {
+        release();
+    }
+
+    FrameBuffer &operator=(const FrameBuffer &other)
+    {
+        if(_block != other._block)
+        {
+            if(other._block)
+                other._block->ref.ref();
+            release();
+            _block = other._block;
+        }
+        return *this;
+    }
+
+    T *data() { return _block ? _block->data : 0; }
+    const T *constData() const { return _block ? _block->data : 0; }
+    int size() const { return _block ? _block->size : 0; }
+    int capacity() const { return _block ? _block->capacity : 0; }
+    bool isNull() const { return _block == 0; }
+    T &operator[](int i) { return _block->data[i]; }
+    const T &operator[](int i) const { return _block->data[i]; }
+
+    /**
+     * Shrinking or growing within capacity keeps the same block,
+     * growing beyond it moves the contents to a larger one.
+     */
+    void resize(int size)
+    {
+        if(!_block)
+        {
+            if(size > 0)
+                _block = FrameBufferPool<T>::instance()->acquire(size);
+            return;
+        }
+        if(size <= _block->capacity)
+        {
+            _block->size = size;
+            return;
+        }
+        Block *block = FrameBufferPool<T>::instance()->acquire(size);
+        memcpy(block->data, _block->data, _block->size * sizeof(T));
+        release();
+        _block = block;
+    }
+
+    void clear()
+    {
+        release();
+    }
+
+private:
+    void release()
+    {
+        if(_block && !_block->ref.deref())
+            FrameBufferPool<T>::instance()->release(_block);
+        _block = 0;
+    }
+
+    Block *_block;
+};
+
+typedef FrameBuffer<unsigned char> ByteFrame;
+typedef FrameBuffer<short> PcmFrame;
+typedef FrameBuffer<float> FloatFrame;
+
+Q_DECLARE_METATYPE(ByteFrame)
+Q_DECLARE_METATYPE(PcmFrame)
+Q_DECLARE_METATYPE(FloatFrame)
+
+#endif // FRAMEBUFFER_H
@@ -0,0 +1,78 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <QAtomicInt>
+
+/**
+ * @brief Bounded lock-free queue between exactly one producer thread and
+ * one consumer thread.
+ *
+ * The producer only writes the tail index and the consumer only the head,
+ * each published with release ordering, so neither side ever blocks.
+ * Capacity must be a power of two, one slot is kept free to tell a full
+ * queue from an empty one.
+ */
+template <typename T, int Capacity>
+class SpscQueue
+{
+public:
+    SpscQueue() : _head(0), _tail(0) {}
+
+    /// Producer side, returns false when the queue is full
+    bool push(const T &item)
+    {
+        int tail = _tail.fetchAndAddAcquire(0);
+        int next = (tail + 1) & (Capacity - 1);
+        if(next == _head.fetchAndAddAcquire(0))
+            return false;
+        _items[tail] = item;
+        _tail.fetchAndStoreRelease(next);
+        return true;
+    }
+
+    /// Consumer side, returns false when the queue is empty
+    bool pop(T &item)
+    {
+        int head = _head.fetchAndAddAcquire(0);
+        if(head == _tail.fetchAndAddAcquire(0))
+            return false;
+        item = _items[head];
+        // drop the slot's reference so shared buffers return to their pool
+        _items[head] = T();
+        _head.fetchAndStoreRelease((head + 1) & (Capacity - 1));
+        return true;
+    }
+
+    /// Consumer side, drops everything queued so far
+    void clear()
+    {
+        T item;
+        while(pop(item));
+    }
+
+private:
+    // power of two capacity, checked at compile time
+    typedef char capacity_check[((Capacity & (Capacity - 1)) == 0) ? 1 : -1];
+
+    T _items[Capacity];
+    QAtomicInt _head;
+    QAtomicInt _tail;
+};
+
+#endif // SPSCQUEUE_H
@@ -42,7 +42,7 @@ void addPreamble(quint8 *buffer, quint16 type, quint32 len)
     buffer[2] = (len >> 24) & 0xff;
 }
 
-void getPreamble(quint8 *buffer, int *type, int *len)
+void getPreamble(const quint8 *buffer, int *type, int *len)
 {
     quint16 msgType;
     quint32 msgLen;
@@ -10,7 +10,7 @@
 
 void genRandomStr(char *str, const int len);
 void addPreamble(quint8 *buffer, quint16 type, quint32 len);
-void getPreamble(quint8 *buffer, int *type, int *len);
+void getPreamble(const quint8 *buffer, int *type, int *len);
 
 
 
@@ -0,0 +1,124 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "gateway.h"
+
+Gateway::Gateway(Settings *settings, QObject *parent) :
+    QObject(parent)
+{
+    _settings = settings;
+}
+
+Gateway::~Gateway()
+{
+    // the radios use the voice path of their client, they go first
+    stop();
+    for(int i=0;i<_links.size();i++)
+        delete _links[i].client;
+}
+
+void Gateway::start()
+{
+    for(int i=0;i<_settings->_gateway_channels.size();i++)
+    {
+        const GatewayChannel &channel = _settings->_gateway_channels.at(i);
+        Link link;
+        link.mumble_channel = channel.mumble_channel;
+        link.client = new MumbleClient(_settings);
+        // no GUI sinks, the flowgraph runs them into null sinks
+        link.radio = new RadioOp(_settings, gr::qtgui::vector_sink_f::sptr(),
+                                 gr::qtgui::const_sink_c::sptr(), gr::qtgui::number_sink::sptr());
+        link.radio->setGatewayChannel(channel);
+        link.radio->setVoipSource(link.client->voice());
+        link.radio_thread = new QThread;
+        link.radio_thread->setObjectName(QString("gateway%1").arg(i));
+        link.radio->moveToThread(link.radio_thread);
+        QObject::connect(link.radio_thread, SIGNAL(started()), link.radio, SLOT(run()));
+        // direct, stop() waits for the thread after the main event loop has ended;
+        // the radio and its thread are deleted there as well
+        QObject::connect(link.radio, SIGNAL(finished()), link.radio_thread, SLOT(quit()),
+                         Qt::DirectConnection);
+        QObject::connect(link.radio, SIGNAL(pingServer()), link.client, SLOT(pingServer()));
+        QObject::connect(link.radio, SIGNAL(printText(QString)), this, SLOT(radioText(QString)));
+        QObject::connect(link.radio, SIGNAL(voipData(PcmFrame)), link.client->voice(), SLOT(sendAudio(PcmFrame)),
+                         Qt::DirectConnection);
+        QObject::connect(link.client, SIGNAL(serverSynchronized()), this, SLOT(clientSynchronized()));
+        _links.append(link);
+        link.radio_thread->start();
+
+        // queued, they run from the event processing of the radio loop
+        QMetaObject::invokeMethod(link.radio, "toggleRxMode", Qt::QueuedConnection,
+                                  Q_ARG(int, channel.rx_mode));
+        QMetaObject::invokeMethod(link.radio, "toggleTxMode", Qt::QueuedConnection,
+                                  Q_ARG(int, channel.tx_mode));
+        QMetaObject::invokeMethod(link.radio, "toggleRX", Qt::QueuedConnection, Q_ARG(bool, true));
+        if(!channel.tx_device_args.isEmpty())
+            QMetaObject::invokeMethod(link.radio, "toggleTX", Qt::QueuedConnection, Q_ARG(bool, true));
+        QMetaObject::invokeMethod(link.radio, "setVOIPForwarding", Qt::QueuedConnection, Q_ARG(bool, true));
+
+        link.client->connectToServer(_settings->voip_server, _settings->_voice_server_port);
+        qDebug() << "Gateway channel" << i << "on" << channel.rx_frequency
+                 << "Hz to Mumble channel" << channel.mumble_channel;
+    }
+}
+
+/// Stops every radio and waits for its thread, so none of them still uses a client
+void Gateway::stop()
+{
+    for(int i=0;i<_links.size();i++)
+    {
+        if(_links[i].radio)
+            QMetaObject::invokeMethod(_links[i].radio, "stop", Qt::QueuedConnection);
+    }
+    for(int i=0;i<_links.size();i++)
+    {
+        Link &link = _links[i];
+        if(!link.radio)
+            continue;
+        link.radio_thread->wait();
+        delete link.radio;
+        delete link.radio_thread;
+        link.radio = 0;
+        link.radio_thread = 0;
+        link.client->disconnectFromServer();
+    }
+}
+
+void Gateway::clientSynchronized()
+{
+    MumbleClient *client = qobject_cast<MumbleClient*>(sender());
+    for(int i=0;i<_links.size();i++)
+    {
+        if(_links[i].client != client)
+            continue;
+        if(_links[i].mumble_channel > 0)
+            client->joinChannel(_links[i].mumble_channel);
+        // every channel has its own voice socket on an ephemeral port
+        if(!_settings->_mumble_tcp)
+        {
+            int port = client->voice()->localPort();
+            if(port > 0)
+                qDebug() << "Gateway channel" << i << "voice on UDP port" << port;
+            else
+                qDebug() << "Gateway channel" << i << "has no UDP voice socket";
+        }
+    }
+}
+
+void Gateway::radioText(QString text)
+{
+    qDebug() << sender()->thread()->objectName() << text.trimmed();
+}
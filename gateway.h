@@ -0,0 +1,66 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef GATEWAY_H
+#define GATEWAY_H
+
+#include <QObject>
+#include <QThread>
+#include <QVector>
+#include <QString>
+#include <QMetaObject>
+#include <QDebug>
+#include "settings.h"
+#include "mumbleclient.h"
+#include "radioop.h"
+
+/**
+ * @brief Headless RF to Mumble gateway.
+ *
+ * Runs one radio per configured gateway channel in a single process. Every
+ * channel gets its own RadioOp thread for modem and vocoder work and its own
+ * Mumble session, whose voice thread does the Opus and crypto work, so the
+ * load spreads over two threads per channel.
+ */
+class Gateway : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Gateway(Settings *settings, QObject *parent = 0);
+    ~Gateway();
+    void start();
+
+public slots:
+    void stop();
+
+private slots:
+    void clientSynchronized();
+    void radioText(QString text);
+
+private:
+    struct Link
+    {
+        RadioOp *radio;
+        QThread *radio_thread;
+        MumbleClient *client;
+        int mumble_channel;
+    };
+
+    Settings *_settings;
+    QVector<Link> _links;
+};
+
+#endif // GATEWAY_H
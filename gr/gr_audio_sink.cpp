@@ -39,20 +39,21 @@ gr_audio_sink::~gr_audio_sink()
     delete _data;
 }
 
-std::vector<float> *gr_audio_sink::get_data()
+int gr_audio_sink::available()
 {
     gr::thread::scoped_lock guard(_mutex);
+    return _data->size();
+}
 
-    std::vector<float>* data = new std::vector<float>;
-    if(_data->size() < 320)
-    {
-        return data;
-    }
-    data->reserve(_data->size());
-    data->insert(data->end(),_data->begin(),_data->end());
-    _data->clear();
-
-    return data;
+int gr_audio_sink::get_data(float *out, int max)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    int n = std::min((int)_data->size(), max);
+    if(n < 1)
+        return 0;
+    memcpy(out, &(_data->at(0)), n * sizeof(float));
+    _data->erase(_data->begin(), _data->begin() + n);
+    return n;
 }
 
 int gr_audio_sink::work(int noutput_items,
@@ -65,11 +66,8 @@ int gr_audio_sink::work(int noutput_items,
         return noutput_items;
     }
     gr::thread::scoped_lock guard(_mutex);
-    float *in = (float*)(input_items[0]);
-    for(int i=0;i < noutput_items;i++)
-    {
-        _data->push_back(in[i]);
-    }
+    const float *in = (const float*)(input_items[0]);
+    _data->insert(_data->end(), in, in + noutput_items);
 
     return noutput_items;
 }
@@ -22,6 +22,8 @@
 #include <gnuradio/sync_interpolator.h>
 #include <gnuradio/io_signature.h>
 #include <stdio.h>
+#include <string.h>
+#include <algorithm>
 
 class gr_audio_sink;
 typedef boost::shared_ptr<gr_audio_sink> gr_audio_sink_sptr;
@@ -37,7 +39,8 @@ public:
            gr_vector_const_void_star &input_items,
            gr_vector_void_star &output_items);
 
-    std::vector<float>* get_data();
+    int available();
+    int get_data(float *out, int max);
 
 private:
     unsigned int _offset;
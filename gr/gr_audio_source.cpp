@@ -39,14 +39,13 @@ gr_audio_source::~gr_audio_source()
     delete _data;
 }
 
-int gr_audio_source::set_data(std::vector<float> *data)
+int gr_audio_source::set_data(const float *data, int size)
 {
 
     if(_offset == 0)
     {
         gr::thread::scoped_lock guard(_mutex);
-        _data->insert(_data->end(),data->begin(),data->end());
-        delete data;
+        _data->insert(_data->end(), data, data + size);
         _finished = false;
         return 0;
     }
@@ -56,6 +55,13 @@ int gr_audio_source::set_data(std::vector<float> *data)
     }
 }
 
+/// True once everything handed to set_data has been sent downstream
+bool gr_audio_source::is_idle()
+{
+    gr::thread::scoped_lock guard(_mutex);
+    return _finished;
+}
+
 int gr_audio_source::work(int noutput_items,
        gr_vector_const_void_star &input_items,
        gr_vector_void_star &output_items)
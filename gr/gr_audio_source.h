@@ -38,7 +38,8 @@ public:
            gr_vector_const_void_star &input_items,
            gr_vector_void_star &output_items);
 
-    int set_data(std::vector<float> *data);
+    int set_data(const float *data, int size);
+    bool is_idle();
 private:
     unsigned _offset;
     bool _finished;
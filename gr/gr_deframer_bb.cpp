@@ -41,6 +41,17 @@ gr_deframer_bb::gr_deframer_bb(int modem_type) :
     {
         _bit_buf_len = 4*8;
     }
+    _voice_bit_buf_len = _bit_buf_len;
+    _current_bit_buf_len = _bit_buf_len;
+}
+
+/// Voice frames may carry several vocoder frames behind one sync word
+void gr_deframer_bb::set_frame_length(int frame_length, int voice_frames)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    int start_bytes = (_modem_type == 1) ? 1 : 0;
+    _bit_buf_len = (frame_length + start_bytes) * 8;
+    _voice_bit_buf_len = (frame_length * voice_frames + start_bytes) * 8;
 }
 
 gr_deframer_bb::~gr_deframer_bb()
@@ -140,6 +151,9 @@ int gr_deframer_bb::work(int noutput_items, gr_vector_const_void_star &input_ite
                     _data->push_back((unsigned char)((current_frame_type >> (bits-1-k)) & 0x1));
                 }
                 _bit_buf_index = 0;
+                gr::thread::scoped_lock guard(_mutex);
+                _current_bit_buf_len = (current_frame_type == 0xED89) ?
+                            _voice_bit_buf_len : _bit_buf_len;
                 continue;
             }
         }
@@ -148,7 +162,7 @@ int gr_deframer_bb::work(int noutput_items, gr_vector_const_void_star &input_ite
             gr::thread::scoped_lock guard(_mutex);
             _data->push_back(in[i] & 0x1);
             _bit_buf_index++;
-            if(_bit_buf_index >= _bit_buf_len)
+            if(_bit_buf_index >= _current_bit_buf_len)
             {
                 _sync_found = false;
                 _shift_reg = 0;
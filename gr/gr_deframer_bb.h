@@ -37,6 +37,7 @@ public:
            gr_vector_const_void_star &input_items,
            gr_vector_void_star &output_items);
     std::vector<unsigned char> * get_data();
+    void set_frame_length(int frame_length, int voice_frames);
 
 private:
     int findSync(unsigned char bit);
@@ -44,6 +45,8 @@ private:
     bool _sync_found;
     long _bit_buf_index;
     int _bit_buf_len;
+    int _voice_bit_buf_len;
+    int _current_bit_buf_len;
     unsigned long long _shift_reg;
     unsigned int _offset;
     bool _finished;
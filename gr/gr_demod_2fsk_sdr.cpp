@@ -46,20 +46,20 @@ gr_demod_2fsk_sdr::gr_demod_2fsk_sdr(std::vector<int>signature, int sps, int sam
     map.push_back(0);
     map.push_back(1);
 
-    std::vector<float> taps = gr::filter::firdes::low_pass(32, _samp_rate, _filter_width, 12000);
-    std::vector<float> symbol_filter_taps = gr::filter::firdes::low_pass(1.0,
+    std::vector<float> taps = gr_taps_cache::low_pass(32, _samp_rate, _filter_width, 12000);
+    std::vector<float> symbol_filter_taps = gr_taps_cache::low_pass(1.0,
                                  _target_samp_rate, _target_samp_rate/_samples_per_symbol, _target_samp_rate*0.25/_samples_per_symbol);
     _resampler = gr::filter::rational_resampler_base_ccf::make(1, 25, taps);
     //_freq_transl_filter = gr::filter::freq_xlating_fir_filter_ccf::make(
     //            1,gr::filter::firdes::low_pass(
     //                1, _target_samp_rate, 2*_filter_width, 250000, gr::filter::firdes::WIN_HAMMING), 25000,
     //            _target_samp_rate);
-    _filter = gr::filter::fft_filter_ccf::make(1, gr::filter::firdes::low_pass(
+    _filter = gr::filter::fft_filter_ccf::make(1, gr_taps_cache::low_pass(
                                 1, _target_samp_rate, _filter_width,1200,gr::filter::firdes::WIN_HAMMING) );
 
-    _upper_filter = gr::filter::fft_filter_ccc::make(1, gr::filter::firdes::complex_band_pass(
+    _upper_filter = gr::filter::fft_filter_ccc::make(1, gr_taps_cache::complex_band_pass(
                                 1, _target_samp_rate, -_filter_width,0,600,gr::filter::firdes::WIN_HAMMING) );
-    _lower_filter = gr::filter::fft_filter_ccc::make(1, gr::filter::firdes::complex_band_pass(
+    _lower_filter = gr::filter::fft_filter_ccc::make(1, gr_taps_cache::complex_band_pass(
                                 1, _target_samp_rate, 0,_filter_width,600,gr::filter::firdes::WIN_HAMMING) );
     _mag_squared_lower = gr::blocks::complex_to_mag_squared::make();
     _mag_squared_upper = gr::blocks::complex_to_mag_squared::make();
@@ -139,4 +139,8 @@ std::vector<unsigned char>* gr_demod_2fsk_sdr::getFrame2()
     return data;
 }
 
-
+void gr_demod_2fsk_sdr::set_frame_length(int frame_length, int voice_frames)
+{
+    _deframer1->set_frame_length(frame_length, voice_frames);
+    _deframer2->set_frame_length(frame_length, voice_frames);
+}
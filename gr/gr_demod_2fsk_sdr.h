@@ -39,6 +39,7 @@
 #include <gnuradio/blocks/add_const_ff.h>
 #include <gnuradio/blocks/delay.h>
 #include "gr_deframer_bb.h"
+#include "gr_taps_cache.h"
 
 class gr_demod_2fsk_sdr;
 
@@ -53,6 +54,7 @@ public:
                                int filter_width=1800);
     std::vector<unsigned char> *getFrame1();
     std::vector<unsigned char> *getFrame2();
+    void set_frame_length(int frame_length, int voice_frames);
 
 private:
     gr::blocks::multiply_const_cc::sptr _multiply_symbols;
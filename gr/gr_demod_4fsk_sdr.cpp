@@ -77,8 +77,8 @@ gr_demod_4fsk_sdr::gr_demod_4fsk_sdr(std::vector<int>signature, int sps, int sam
     gr::digital::constellation_expl_rect::sptr constellation = gr::digital::constellation_expl_rect::make(
                 constellation_points,pre_diff_code,2,4,1,1,1,const_map);
 
-    std::vector<float> taps = gr::filter::firdes::low_pass(flt_size, _samp_rate, _filter_width, 12000);
-    std::vector<float> symbol_filter_taps = gr::filter::firdes::low_pass(1.0,
+    std::vector<float> taps = gr_taps_cache::low_pass(flt_size, _samp_rate, _filter_width, 12000);
+    std::vector<float> symbol_filter_taps = gr_taps_cache::low_pass(1.0,
                                  _target_samp_rate, _target_samp_rate*0.75/_samples_per_symbol, _target_samp_rate*0.25/_samples_per_symbol);
     _resampler = gr::filter::rational_resampler_base_ccf::make(1, 25, taps);
 
@@ -86,17 +86,17 @@ gr_demod_4fsk_sdr::gr_demod_4fsk_sdr(std::vector<int>signature, int sps, int sam
     //            1,gr::filter::firdes::low_pass(
     //                1, _target_samp_rate, 2*_filter_width, 250000, gr::filter::firdes::WIN_HAMMING), 25000,
     //            _target_samp_rate);
-    _filter = gr::filter::fft_filter_ccf::make(1, gr::filter::firdes::low_pass(
+    _filter = gr::filter::fft_filter_ccf::make(1, gr_taps_cache::low_pass(
                                 1, _target_samp_rate, _filter_width,1200,gr::filter::firdes::WIN_HAMMING) );
     //_freq_demod = gr::analog::quadrature_demod_cf::make(sps/(4*M_PI/2));
 
-    _filter1 = gr::filter::fft_filter_ccc::make(1, gr::filter::firdes::complex_band_pass(
+    _filter1 = gr::filter::fft_filter_ccc::make(1, gr_taps_cache::complex_band_pass(
                                 1, _target_samp_rate, -_filter_width,-_filter_width+rs,bw,gr::filter::firdes::WIN_BLACKMAN_HARRIS) );
-    _filter2 = gr::filter::fft_filter_ccc::make(1, gr::filter::firdes::complex_band_pass(
+    _filter2 = gr::filter::fft_filter_ccc::make(1, gr_taps_cache::complex_band_pass(
                                 1, _target_samp_rate, -_filter_width+rs,0,bw,gr::filter::firdes::WIN_BLACKMAN_HARRIS) );
-    _filter3 = gr::filter::fft_filter_ccc::make(1, gr::filter::firdes::complex_band_pass(
+    _filter3 = gr::filter::fft_filter_ccc::make(1, gr_taps_cache::complex_band_pass(
                                 1, _target_samp_rate, 0,_filter_width-rs,bw,gr::filter::firdes::WIN_BLACKMAN_HARRIS) );
-    _filter4 = gr::filter::fft_filter_ccc::make(1, gr::filter::firdes::complex_band_pass(
+    _filter4 = gr::filter::fft_filter_ccc::make(1, gr_taps_cache::complex_band_pass(
                                 1, _target_samp_rate, _filter_width-rs,_filter_width, bw,gr::filter::firdes::WIN_BLACKMAN_HARRIS) );
     _mag_squared1 = gr::blocks::complex_to_mag::make();
     _mag_squared2 = gr::blocks::complex_to_mag::make();
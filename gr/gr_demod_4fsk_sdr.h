@@ -36,6 +36,7 @@
 #include <gnuradio/digital/descrambler_bb.h>
 #include <gnuradio/blocks/complex_to_mag_squared.h>
 #include "gr_4fsk_discriminator.h"
+#include "gr_taps_cache.h"
 
 class gr_demod_4fsk_sdr;
 
@@ -44,11 +44,11 @@ gr_demod_am_sdr::gr_demod_am_sdr(std::vector<int>signature, int sps, int samp_ra
 
     float rerate = (float)_target_samp_rate/(float)_samp_rate;
 
-    std::vector<float> taps = gr::filter::firdes::low_pass(1, _samp_rate, _filter_width, 10000);
-    std::vector<float> audio_taps = gr::filter::firdes::low_pass(1, _target_samp_rate, _filter_width, 10000);
+    std::vector<float> taps = gr_taps_cache::low_pass(1, _samp_rate, _filter_width, 10000);
+    std::vector<float> audio_taps = gr_taps_cache::low_pass(1, _target_samp_rate, _filter_width, 10000);
     _resampler = gr::filter::pfb_arb_resampler_ccf::make(rerate, taps, 32);
     _audio_resampler = gr::filter::rational_resampler_base_fff::make(2,5, audio_taps);
-    _filter = gr::filter::fft_filter_ccc::make(1, gr::filter::firdes::complex_band_pass(
+    _filter = gr::filter::fft_filter_ccc::make(1, gr_taps_cache::complex_band_pass(
                             1, _target_samp_rate, -_filter_width, _filter_width,1200,gr::filter::firdes::WIN_HAMMING) );
     _squelch = gr::analog::pwr_squelch_cc::make(-140,0.01,0,true);
     _agc = gr::analog::agc2_cc::make(0.6e-1, 1e-3, 0.5, 1);
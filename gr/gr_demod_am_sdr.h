@@ -28,6 +28,7 @@
 #include <gnuradio/blocks/complex_to_real.h>
 #include <gnuradio/blocks/complex_to_mag.h>
 #include <gnuradio/blocks/multiply_const_ff.h>
+#include "gr_taps_cache.h"
 
 
 class gr_demod_am_sdr;
@@ -16,7 +16,7 @@
 
 #include "gr_demod_base.h"
 
-gr_demod_base::gr_demod_base(gr::qtgui::sink_c::sptr fft_gui,
+gr_demod_base::gr_demod_base(gr::qtgui::vector_sink_f::sptr fft_gui,
                              gr::qtgui::const_sink_c::sptr const_gui, gr::qtgui::number_sink::sptr rssi_gui,
                               QObject *parent, float device_frequency,
                              float rf_gain, std::string device_args, std::string device_antenna,
@@ -38,19 +38,24 @@ gr_demod_base::gr_demod_base(gr::qtgui::sink_c::sptr fft_gui,
 
     _message_sink = gr::blocks::message_debug::make();
 
-    _rssi_valve = gr::blocks::copy::make(8);
+    _rssi_valve = gr::blocks::copy::make(sizeof(float));
     _rssi_valve->set_enabled(false);
-    _fft_valve = gr::blocks::copy::make(8);
-    _fft_valve->set_enabled(false);
     _const_valve = gr::blocks::copy::make(8);
     _const_valve->set_enabled(false);
-    _mag_squared = gr::blocks::complex_to_mag_squared::make();
-    _single_pole_filter = gr::filter::single_pole_iir_filter_ff::make(0.04);
-    _log10 = gr::blocks::nlog10_ff::make();
-    _multiply_const_ff = gr::blocks::multiply_const_ff::make(10);
     _agc2 = gr::analog::agc2_ff::make(0.6e-1, 1e-3, 1, 1);
-    _moving_average = gr::blocks::moving_average_ff::make(25000,1,2000);
-    _add_const = gr::blocks::add_const_ff::make(-110);
+    // offsets keep the scale of the former 25000 sample moving sum chain
+    _rssi_meter = make_gr_rssi_cf(20000, 10, -66);
+    // the FFT display shows the averaged frames, they are computed only
+    // while it is visible or the scanner needs them
+    _spectrum = make_gr_spectrum_cc(8192, 1000000, 10, 4);
+    _spectrum->set_analysis(false);
+    // coarse carrier estimation looks at 50 kHz around the channel, ahead of
+    // the demodulator filters, and only for the duration of one acquisition burst
+    _carrier_valve = gr::blocks::copy::make(sizeof(gr_complex));
+    _carrier_valve->set_enabled(false);
+    _carrier_filter = gr::filter::fft_filter_ccf::make(20, gr_taps_cache::low_pass(
+                1, 1000000, 20000, 5000, gr::filter::firdes::WIN_HAMMING));
+    _carrier_spectrum = make_gr_spectrum_cc(1024, 50000, 20, 4);
 
 
     _osmosdr_source = osmosdr::source::make(device_args);
@@ -79,18 +84,25 @@ gr_demod_base::gr_demod_base(gr::qtgui::sink_c::sptr fft_gui,
 
     _top_block->connect(_osmosdr_source,0,_multiply,0);
     _top_block->connect(_signal_source,0,_multiply,1);
-    _top_block->connect(_multiply,0,_fft_valve,0);
-    _top_block->connect(_fft_valve,0,_fft_gui,0);
-    _top_block->msg_connect(_fft_gui,"freq",_message_sink,"store");
+    _top_block->connect(_multiply,0,_spectrum,0);
+    // headless channels (gateway mode) have no GUI sinks, the spectrum
+    // output is optional and the meters run into null sinks instead
+    if(_fft_gui)
+    {
+        _top_block->connect(_spectrum,0,_fft_gui,0);
+        // a double click on the plot posts its frequency axis value
+        _top_block->msg_connect(_fft_gui,"x",_message_sink,"store");
+    }
 
 
-    _top_block->connect(_rssi_valve,0,_mag_squared,0);
-    _top_block->connect(_mag_squared,0,_moving_average,0);
-    _top_block->connect(_moving_average,0,_single_pole_filter,0);
-    _top_block->connect(_single_pole_filter,0,_log10,0);
-    _top_block->connect(_log10,0,_multiply_const_ff,0);
-    _top_block->connect(_multiply_const_ff,0,_add_const,0);
-    _top_block->connect(_add_const,0,_rssi,0);
+    _top_block->connect(_rssi_meter,0,_rssi_valve,0);
+    if(_rssi)
+        _top_block->connect(_rssi_valve,0,_rssi,0);
+    else
+        _top_block->connect(_rssi_valve,0,gr::blocks::null_sink::make(sizeof(float)),0);
+    _top_block->connect(_multiply,0,_carrier_valve,0);
+    _top_block->connect(_carrier_valve,0,_carrier_filter,0);
+    _top_block->connect(_carrier_filter,0,_carrier_spectrum,0);
 
 
 
@@ -110,6 +122,40 @@ gr_demod_base::gr_demod_base(gr::qtgui::sink_c::sptr fft_gui,
     _ssb = make_gr_demod_ssb_sdr(0, 1000000,1700,2500);
     _wfm = make_gr_demod_wbfm_sdr(0, 1000000,1700,75000);
 
+    // every demodulator stays connected, mode switches only move valves
+    // and selector inputs so the flowgraph never has to be locked
+    _rssi_select = make_gr_mode_selector(sizeof(gr_complex), 16);
+    _const_select = make_gr_mode_selector(sizeof(gr_complex), 16);
+    _audio_select = make_gr_mode_selector(sizeof(float), 16);
+    _data_select = make_gr_mode_selector(sizeof(unsigned char), 16);
+    _rssi_inputs = 0;
+    _const_inputs = 0;
+    _audio_inputs = 0;
+    _data_inputs = 0;
+
+    _top_block->connect(_rssi_select,0,_rssi_meter,0);
+    _top_block->connect(_const_select,0,_const_valve,0);
+    if(_constellation)
+        _top_block->connect(_const_valve,0,_constellation,0);
+    else
+        _top_block->connect(_const_valve,0,gr::blocks::null_sink::make(sizeof(gr_complex)),0);
+    _top_block->connect(_audio_select,0,_audio_sink,0);
+    _top_block->connect(_data_select,0,_vector_sink,0);
+
+    add_rx_chain(gr_modem_types::ModemType2FSK2000, _2fsk, 40000, -66, 25000, false, false);
+    add_rx_chain(gr_modem_types::ModemType4FSK2000, _4fsk_2k, 40000, -66, 25000, false, true);
+    add_rx_chain(gr_modem_types::ModemType4FSK20000, _4fsk_10k, 40000, -66, 25000, false, true);
+    add_rx_chain(gr_modem_types::ModemTypeAM5000, _am, 20000, -11, 25000, true, false);
+    add_rx_chain(gr_modem_types::ModemTypeBPSK1000, _bpsk_1k, 20000, -66, 25000, false, false);
+    add_rx_chain(gr_modem_types::ModemTypeBPSK2000, _bpsk_2k, 20000, -66, 25000, false, false);
+    add_rx_chain(gr_modem_types::ModemTypeNBFM2500, _fm_2500, 40000, -11, 25000, true, false);
+    add_rx_chain(gr_modem_types::ModemTypeNBFM5000, _fm_5000, 40000, -11, 25000, true, false);
+    add_rx_chain(gr_modem_types::ModemTypeQPSK2000, _qpsk_2k, 20000, -66, 25000, false, true);
+    add_rx_chain(gr_modem_types::ModemTypeQPSK20000, _qpsk_10k, 20000, -66, 25000, false, true);
+    add_rx_chain(gr_modem_types::ModemTypeQPSK250000, _qpsk_250k, 250000, -66, 250000, false, true);
+    add_rx_chain(gr_modem_types::ModemTypeQPSKVideo, _qpsk_video, 250000, -66, 250000, false, true);
+    add_rx_chain(gr_modem_types::ModemTypeSSB2500, _ssb, 20000, -11, 25000, true, false);
+    add_rx_chain(gr_modem_types::ModemTypeWBFM, _wfm, 200000, -11, 250000, true, false);
 }
 
 gr_demod_base::~gr_demod_base()
@@ -117,253 +163,73 @@ gr_demod_base::~gr_demod_base()
     _osmosdr_source.reset();
 }
 
-void gr_demod_base::set_mode(int mode)
+/**
+ * Port 0 of every demodulator carries the filtered baseband used for RSSI,
+ * port 1 either the constellation or the audio and port 2, if present,
+ * the demodulated bits.
+ */
+void gr_demod_base::add_rx_chain(int mode, gr::basic_block_sptr demod, int samp_rate, float rssi_offset,
+                                 int carrier_offset, bool audio, bool data)
 {
-    _top_block->lock();
-
-    switch(_mode)
+    rx_chain chain;
+    chain.valve = gr::blocks::copy::make(sizeof(gr_complex));
+    chain.valve->set_enabled(false);
+    chain.samp_rate = samp_rate;
+    chain.rssi_offset = rssi_offset;
+    chain.carrier_offset = carrier_offset;
+    chain.rssi_input = _rssi_inputs++;
+    chain.const_input = -1;
+    chain.audio_input = -1;
+    chain.data_input = -1;
+
+    _top_block->connect(_multiply,0,chain.valve,0);
+    _top_block->connect(chain.valve,0,demod,0);
+    _top_block->connect(demod,0,_rssi_select,chain.rssi_input);
+    if(audio)
     {
-    case gr_modem_types::ModemType2FSK2000:
-        _top_block->disconnect(_multiply,0,_2fsk,0);
-        _top_block->disconnect(_2fsk,0,_rssi_valve,0);
-        _top_block->disconnect(_2fsk,1,_const_valve,0);
-        _top_block->disconnect(_const_valve,0,_constellation,0);
-        break;
-    case gr_modem_types::ModemType4FSK2000:
-        _top_block->disconnect(_multiply,0,_4fsk_2k,0);
-        _top_block->disconnect(_4fsk_2k,0,_rssi_valve,0);
-        _top_block->disconnect(_4fsk_2k,1,_const_valve,0);
-        _top_block->disconnect(_const_valve,0,_constellation,0);
-        _top_block->disconnect(_4fsk_2k,2,_vector_sink,0);
-        break;
-    case gr_modem_types::ModemType4FSK20000:
-        _top_block->disconnect(_multiply,0,_4fsk_10k,0);
-        _top_block->disconnect(_4fsk_10k,0,_rssi_valve,0);
-        _top_block->disconnect(_4fsk_10k,1,_const_valve,0);
-        _top_block->disconnect(_const_valve,0,_constellation,0);
-        _top_block->disconnect(_4fsk_10k,2,_vector_sink,0);
-        break;
-    case gr_modem_types::ModemTypeAM5000:
-        _top_block->disconnect(_multiply,0,_am,0);
-        _top_block->disconnect(_am,0,_rssi_valve,0);
-        _top_block->disconnect(_am,1,_audio_sink,0);
-        break;
-    case gr_modem_types::ModemTypeBPSK1000:
-        _top_block->disconnect(_multiply,0,_bpsk_1k,0);
-        _top_block->disconnect(_bpsk_1k,0,_rssi_valve,0);
-        _top_block->disconnect(_bpsk_1k,1,_const_valve,0);
-        _top_block->disconnect(_const_valve,0,_constellation,0);
-        break;
-    case gr_modem_types::ModemTypeBPSK2000:
-        _top_block->disconnect(_multiply,0,_bpsk_2k,0);
-        _top_block->disconnect(_bpsk_2k,0,_rssi_valve,0);
-        _top_block->disconnect(_bpsk_2k,1,_const_valve,0);
-        _top_block->disconnect(_const_valve,0,_constellation,0);
-        break;
-    case gr_modem_types::ModemTypeNBFM2500:
-        _top_block->disconnect(_multiply,0,_fm_2500,0);
-        _top_block->disconnect(_fm_2500,0,_rssi_valve,0);
-        _top_block->disconnect(_fm_2500,1,_audio_sink,0);
-        break;
-    case gr_modem_types::ModemTypeNBFM5000:
-        _top_block->disconnect(_multiply,0,_fm_5000,0);
-        _top_block->disconnect(_fm_5000,0,_rssi_valve,0);
-        _top_block->disconnect(_fm_5000,1,_audio_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSK2000:
-        _top_block->disconnect(_multiply,0,_qpsk_2k,0);
-        _top_block->disconnect(_qpsk_2k,0,_rssi_valve,0);
-        _top_block->disconnect(_qpsk_2k,1,_const_valve,0);
-        _top_block->disconnect(_const_valve,0,_constellation,0);
-        _top_block->disconnect(_qpsk_2k,2,_vector_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSK20000:
-        _top_block->disconnect(_multiply,0,_qpsk_10k,0);
-        _top_block->disconnect(_qpsk_10k,0,_rssi_valve,0);
-        _top_block->disconnect(_qpsk_10k,1,_const_valve,0);
-        _top_block->disconnect(_const_valve,0,_constellation,0);
-        _top_block->disconnect(_qpsk_10k,2,_vector_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSK250000:
-        _top_block->disconnect(_multiply,0,_qpsk_250k,0);
-        _top_block->disconnect(_qpsk_250k,0,_rssi_valve,0);
-        _top_block->disconnect(_qpsk_250k,1,_const_valve,0);
-        _top_block->disconnect(_const_valve,0,_constellation,0);
-        _top_block->disconnect(_qpsk_250k,2,_vector_sink,0);
-        _carrier_offset = 25000;
-        _signal_source->set_frequency(-_carrier_offset);
-        _osmosdr_source->set_center_freq(_device_frequency - _carrier_offset);
-        break;
-    case gr_modem_types::ModemTypeQPSKVideo:
-        _top_block->disconnect(_multiply,0,_qpsk_video,0);
-        _top_block->disconnect(_qpsk_video,0,_rssi_valve,0);
-        _top_block->disconnect(_qpsk_video,1,_const_valve,0);
-        _top_block->disconnect(_const_valve,0,_constellation,0);
-        _top_block->disconnect(_qpsk_video,2,_vector_sink,0);
-        _carrier_offset = 25000;
-        _signal_source->set_frequency(-_carrier_offset);
-        _osmosdr_source->set_center_freq(_device_frequency - _carrier_offset);
-        break;
-    case gr_modem_types::ModemTypeSSB2500:
-        _top_block->disconnect(_multiply,0,_ssb,0);
-        _top_block->disconnect(_ssb,0,_rssi_valve,0);
-        _top_block->disconnect(_ssb,1,_audio_sink,0);
-        break;
-    case gr_modem_types::ModemTypeWBFM:
-        _top_block->disconnect(_multiply,0,_wfm,0);
-        _top_block->disconnect(_wfm,0,_rssi_valve,0);
-        _top_block->disconnect(_wfm,1,_audio_sink,0);
-        _carrier_offset = 25000;
-        _signal_source->set_frequency(-_carrier_offset);
-        _osmosdr_source->set_center_freq(_device_frequency - _carrier_offset);
-        break;
-    default:
-        break;
+        chain.audio_input = _audio_inputs++;
+        _top_block->connect(demod,1,_audio_select,chain.audio_input);
     }
+    else
+    {
+        chain.const_input = _const_inputs++;
+        _top_block->connect(demod,1,_const_select,chain.const_input);
+    }
+    if(data)
+    {
+        chain.data_input = _data_inputs++;
+        _top_block->connect(demod,2,_data_select,chain.data_input);
+    }
+    _rx_chains[mode] = chain;
+}
 
-    switch(mode)
+void gr_demod_base::set_mode(int mode)
+{
+    std::map<int, rx_chain>::iterator current = _rx_chains.find(_mode);
+    if(current != _rx_chains.end())
+        current->second.valve->set_enabled(false);
+    _mode = mode;
+    std::map<int, rx_chain>::iterator next = _rx_chains.find(mode);
+    if(next == _rx_chains.end())
+        return;
+
+    const rx_chain &chain = next->second;
+    _rssi_select->set_input_index(chain.rssi_input);
+    if(chain.const_input >= 0)
+        _const_select->set_input_index(chain.const_input);
+    if(chain.audio_input >= 0)
+        _audio_select->set_input_index(chain.audio_input);
+    if(chain.data_input >= 0)
+        _data_select->set_input_index(chain.data_input);
+    _rssi_meter->set_samp_rate(chain.samp_rate);
+    _rssi_meter->set_level_offset(chain.rssi_offset);
+    if(chain.carrier_offset != _carrier_offset)
     {
-    case gr_modem_types::ModemType2FSK2000:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _add_const->set_k(-110);
-        _top_block->connect(_multiply,0,_2fsk,0);
-        _top_block->connect(_2fsk,0,_rssi_valve,0);
-        _top_block->connect(_2fsk,1,_const_valve,0);
-        _top_block->connect(_const_valve,0,_constellation,0);
-        break;
-    case gr_modem_types::ModemType4FSK2000:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _add_const->set_k(-110);
-        _top_block->connect(_multiply,0,_4fsk_2k,0);
-        _top_block->connect(_4fsk_2k,0,_rssi_valve,0);
-        _top_block->connect(_4fsk_2k,1,_const_valve,0);
-        _top_block->connect(_const_valve,0,_constellation,0);
-        _top_block->connect(_4fsk_2k,2,_vector_sink,0);
-        break;
-    case gr_modem_types::ModemType4FSK20000:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _add_const->set_k(-110);
-        _top_block->connect(_multiply,0,_4fsk_10k,0);
-        _top_block->connect(_4fsk_10k,0,_rssi_valve,0);
-        _top_block->connect(_4fsk_10k,1,_const_valve,0);
-        _top_block->connect(_const_valve,0,_constellation,0);
-        _top_block->connect(_4fsk_10k,2,_vector_sink,0);
-        break;
-    case gr_modem_types::ModemTypeAM5000:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _add_const->set_k(-55);
-        _top_block->connect(_multiply,0,_am,0);
-        _top_block->connect(_am,0,_rssi_valve,0);
-        _top_block->connect(_am,1,_audio_sink,0);
-        break;
-    case gr_modem_types::ModemTypeBPSK1000:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _add_const->set_k(-110);
-        _top_block->connect(_multiply,0,_bpsk_1k,0);
-        _top_block->connect(_bpsk_1k,0,_rssi_valve,0);
-        _top_block->connect(_bpsk_1k,1,_const_valve,0);
-        _top_block->connect(_const_valve,0,_constellation,0);
-        break;
-    case gr_modem_types::ModemTypeBPSK2000:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _add_const->set_k(-110);
-        _top_block->connect(_multiply,0,_bpsk_2k,0);
-        _top_block->connect(_bpsk_2k,0,_rssi_valve,0);
-        _top_block->connect(_bpsk_2k,1,_const_valve,0);
-        _top_block->connect(_const_valve,0,_constellation,0);
-        break;
-    case gr_modem_types::ModemTypeNBFM2500:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _add_const->set_k(-55);
-        _top_block->connect(_multiply,0,_fm_2500,0);
-        _top_block->connect(_fm_2500,0,_rssi_valve,0);
-        _top_block->connect(_fm_2500,1,_audio_sink,0);
-        break;
-    case gr_modem_types::ModemTypeNBFM5000:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _add_const->set_k(-55);
-        _top_block->connect(_multiply,0,_fm_5000,0);
-        _top_block->connect(_fm_5000,0,_rssi_valve,0);
-        _top_block->connect(_fm_5000,1,_audio_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSK2000:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _add_const->set_k(-110);
-        _top_block->connect(_multiply,0,_qpsk_2k,0);
-        _top_block->connect(_qpsk_2k,0,_rssi_valve,0);
-        _top_block->connect(_qpsk_2k,1,_const_valve,0);
-        _top_block->connect(_const_valve,0,_constellation,0);
-        _top_block->connect(_qpsk_2k,2,_vector_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSK20000:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _add_const->set_k(-110);
-        _top_block->connect(_multiply,0,_qpsk_10k,0);
-        _top_block->connect(_qpsk_10k,0,_rssi_valve,0);
-        _top_block->connect(_qpsk_10k,1,_const_valve,0);
-        _top_block->connect(_const_valve,0,_constellation,0);
-        _top_block->connect(_qpsk_10k,2,_vector_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSK250000:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _carrier_offset = 250000;
-        _signal_source->set_frequency(-_carrier_offset);
-        _osmosdr_source->set_center_freq(_device_frequency - _carrier_offset);
-        _add_const->set_k(-110);
-        _top_block->connect(_multiply,0,_qpsk_250k,0);
-        _top_block->connect(_qpsk_250k,0,_rssi_valve,0);
-        _top_block->connect(_qpsk_250k,1,_const_valve,0);
-        _top_block->connect(_const_valve,0,_constellation,0);
-        _top_block->connect(_qpsk_250k,2,_vector_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSKVideo:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _carrier_offset = 250000;
+        _carrier_offset = chain.carrier_offset;
         _signal_source->set_frequency(-_carrier_offset);
         _osmosdr_source->set_center_freq(_device_frequency - _carrier_offset);
-        _add_const->set_k(-110);
-        _top_block->connect(_multiply,0,_qpsk_video,0);
-        _top_block->connect(_qpsk_video,0,_rssi_valve,0);
-        _top_block->connect(_qpsk_video,1,_const_valve,0);
-        _top_block->connect(_const_valve,0,_constellation,0);
-        _top_block->connect(_qpsk_video,2,_vector_sink,0);
-        break;
-    case gr_modem_types::ModemTypeSSB2500:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _add_const->set_k(-55);
-        _top_block->connect(_multiply,0,_ssb,0);
-        _top_block->connect(_ssb,0,_rssi_valve,0);
-        _top_block->connect(_ssb,1,_audio_sink,0);
-        break;
-    case gr_modem_types::ModemTypeWBFM:
-        _signal_source->set_sampling_freq(1000000);
-        _osmosdr_source->set_sample_rate(1000000);
-        _carrier_offset = 250000;
-        _signal_source->set_frequency(-_carrier_offset);
-        _osmosdr_source->set_center_freq(_device_frequency - _carrier_offset);
-        _add_const->set_k(-55);
-        _top_block->connect(_multiply,0,_wfm,0);
-        _top_block->connect(_wfm,0,_rssi_valve,0);
-        _top_block->connect(_wfm,1,_audio_sink,0);
-    default:
-        break;
     }
-    _mode = mode;
-
-    _top_block->unlock();
+    chain.valve->set_enabled(true);
 }
 
 void gr_demod_base::start()
@@ -420,16 +286,22 @@ std::vector<unsigned char>* gr_demod_base::getData()
     return data;
 }
 
-std::vector<float>* gr_demod_base::getAudio()
+int gr_demod_base::getAudioAvailable()
 {
-    std::vector<float> *data = _audio_sink->get_data();
-    return data;
+    return _audio_sink->available();
+}
+
+int gr_demod_base::getAudio(float *out, int max)
+{
+    return _audio_sink->get_data(out, max);
 }
 
 void gr_demod_base::tune(long center_freq)
 {
     _device_frequency = center_freq;
     _osmosdr_source->set_center_freq(_device_frequency-_carrier_offset);
+    // averaged frames from the previous frequency are no longer valid
+    _spectrum->reset();
 }
 
 double gr_demod_base::get_freq()
@@ -447,6 +319,11 @@ double gr_demod_base::get_freq()
     }
 }
 
+float gr_demod_base::get_rssi()
+{
+    return _rssi_meter->get_rssi();
+}
+
 void gr_demod_base::set_rx_sensitivity(float value)
 {
     osmosdr::gain_range_t range = _osmosdr_source->get_gain_range();
@@ -465,7 +342,60 @@ void gr_demod_base::enable_gui_const(bool value)
 
 void gr_demod_base::enable_gui_fft(bool value)
 {
-    _fft_valve->set_enabled(value);
+    _spectrum->set_forward(value);
+}
+
+void gr_demod_base::enable_spectrum_analysis(bool value)
+{
+    _spectrum->set_analysis(value);
+}
+
+bool gr_demod_base::get_spectrum(std::vector<float> &frame)
+{
+    return _spectrum->get_spectrum(frame);
+}
+
+uint64_t gr_demod_base::get_spectrum_frames()
+{
+    return _spectrum->get_frame_count();
+}
+
+void gr_demod_base::start_carrier_estimate()
+{
+    _carrier_spectrum->reset();
+    _carrier_valve->set_enabled(true);
+}
+
+/**
+ * Returns -1 while the acquisition burst is still running, 0 if no carrier
+ * stood out of the noise and 1 if offset_hz holds a valid estimate.
+ */
+int gr_demod_base::get_carrier_offset(float &offset_hz)
+{
+    if(_carrier_spectrum->get_frame_count() < 4)
+        return -1;
+    _carrier_valve->set_enabled(false);
+    // the acquisition range matches the +-5 kHz tune limits with some margin,
+    // the noise floor comes from the bins between it and the filter edge
+    if(_carrier_spectrum->estimate_carrier(10.0, 12500, 17500, offset_hz))
+        return 1;
+    return 0;
+}
+
+void gr_demod_base::set_spectrum_params(int frame_rate, int averaging)
+{
+    _spectrum->set_frame_rate(frame_rate);
+    _spectrum->set_averaging(averaging);
+}
+
+void gr_demod_base::set_frame_length(int modem_type, int frame_length, int voice_frames)
+{
+    if(modem_type == gr_modem_types::ModemType2FSK2000)
+        _2fsk->set_frame_length(frame_length, voice_frames);
+    else if(modem_type == gr_modem_types::ModemTypeBPSK2000)
+        _bpsk_2k->set_frame_length(frame_length, voice_frames);
+    else if(modem_type == gr_modem_types::ModemTypeBPSK1000)
+        _bpsk_1k->set_frame_length(frame_length, voice_frames);
 }
 
 void gr_demod_base::set_squelch(int value)
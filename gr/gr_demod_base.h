@@ -25,22 +25,23 @@
 #include <gnuradio/blocks/multiply_cc.h>
 #include <gnuradio/analog/sig_source_c.h>
 #include <gnuradio/qtgui/const_sink_c.h>
-#include <gnuradio/qtgui/sink_c.h>
+#include <gnuradio/qtgui/vector_sink_f.h>
 #include <gnuradio/qtgui/number_sink.h>
 #include <gnuradio/analog/agc2_ff.h>
-#include <gnuradio/blocks/complex_to_mag_squared.h>
-#include <gnuradio/blocks/nlog10_ff.h>
-#include <gnuradio/blocks/multiply_const_ff.h>
-#include <gnuradio/filter/single_pole_iir_filter_ff.h>
-#include <gnuradio/blocks/moving_average_ff.h>
-#include <gnuradio/blocks/add_const_ff.h>
 #include <gnuradio/blocks/delay.h>
 #include <gnuradio/blocks/copy.h>
 #include <gnuradio/blocks/message_debug.h>
+#include <gnuradio/blocks/null_sink.h>
+#include <gnuradio/filter/fft_filter_ccf.h>
 #include <osmosdr/source.h>
 #include <vector>
+#include <map>
 #include "gr_audio_sink.h"
 #include "gr_vector_sink.h"
+#include "gr_rssi_cf.h"
+#include "gr_spectrum_cc.h"
+#include "gr_taps_cache.h"
+#include "gr_mode_selector.h"
 #include "gr_demod_2fsk_sdr.h"
 #include "gr_demod_4fsk_sdr.h"
 #include "gr_demod_am_sdr.h"
@@ -55,7 +56,7 @@ class gr_demod_base : public QObject
 {
     Q_OBJECT
 public:
-    explicit gr_demod_base(gr::qtgui::sink_c::sptr fft_gui,
+    explicit gr_demod_base(gr::qtgui::vector_sink_f::sptr fft_gui,
                                gr::qtgui::const_sink_c::sptr const_gui, gr::qtgui::number_sink::sptr rssi_gui,
                                 QObject *parent = 0, float device_frequency=434000000,
                                float rf_gain=50, std::string device_args="rtl=0", std::string device_antenna="RX2",
@@ -69,7 +70,8 @@ public slots:
     std::vector<unsigned char> *getData();
     std::vector<unsigned char> *getFrame1();
     std::vector<unsigned char> *getFrame2();
-    std::vector<float> *getAudio();
+    int getAudioAvailable();
+    int getAudio(float *out, int max);
     void tune(long center_freq);
     void set_rx_sensitivity(float value);
     void set_squelch(int value);
@@ -77,26 +79,55 @@ public slots:
     void enable_gui_const(bool value);
     void enable_gui_fft(bool value);
     double get_freq();
+    float get_rssi();
+    void enable_spectrum_analysis(bool value);
+    bool get_spectrum(std::vector<float> &frame);
+    uint64_t get_spectrum_frames();
+    void set_spectrum_params(int frame_rate, int averaging);
+    void set_frame_length(int modem_type, int frame_length, int voice_frames);
+    void start_carrier_estimate();
+    int get_carrier_offset(float &offset_hz);
     void set_mode(int mode);
 
 private:
+    struct rx_chain
+    {
+        gr::blocks::copy::sptr valve;
+        int rssi_input;
+        int const_input;
+        int audio_input;
+        int data_input;
+        int samp_rate;
+        float rssi_offset;
+        int carrier_offset;
+    };
+    void add_rx_chain(int mode, gr::basic_block_sptr demod, int samp_rate, float rssi_offset,
+                      int carrier_offset, bool audio, bool data);
+
     gr::top_block_sptr _top_block;
     gr_audio_sink_sptr _audio_sink;
     gr_vector_sink_sptr _vector_sink;
     gr::analog::agc2_ff::sptr _agc2;
     gr::qtgui::const_sink_c::sptr _constellation;
-    gr::qtgui::sink_c::sptr _fft_gui;
+    gr::qtgui::vector_sink_f::sptr _fft_gui;
     gr::qtgui::number_sink::sptr _rssi;
     gr::blocks::message_debug::sptr _message_sink;
     gr::blocks::copy::sptr _rssi_valve;
-    gr::blocks::copy::sptr _fft_valve;
     gr::blocks::copy::sptr _const_valve;
-    gr::blocks::complex_to_mag_squared::sptr _mag_squared;
-    gr::blocks::nlog10_ff::sptr _log10;
-    gr::filter::single_pole_iir_filter_ff::sptr _single_pole_filter;
-    gr::blocks::multiply_const_ff::sptr _multiply_const_ff;
-    gr::blocks::moving_average_ff::sptr _moving_average;
-    gr::blocks::add_const_ff::sptr _add_const;
+    gr_rssi_cf_sptr _rssi_meter;
+    gr_spectrum_cc_sptr _spectrum;
+    gr::blocks::copy::sptr _carrier_valve;
+    gr::filter::fft_filter_ccf::sptr _carrier_filter;
+    gr_spectrum_cc_sptr _carrier_spectrum;
+    gr_mode_selector_sptr _rssi_select;
+    gr_mode_selector_sptr _const_select;
+    gr_mode_selector_sptr _audio_select;
+    gr_mode_selector_sptr _data_select;
+    std::map<int, rx_chain> _rx_chains;
+    int _rssi_inputs;
+    int _const_inputs;
+    int _audio_inputs;
+    int _data_inputs;
 
     gr::analog::sig_source_c::sptr _signal_source;
     gr::blocks::multiply_cc::sptr _multiply;
@@ -47,21 +47,21 @@ gr_demod_bpsk_sdr::gr_demod_bpsk_sdr(std::vector<int>signature, int sps, int sam
 
     unsigned int flt_size = 32;
 
-    std::vector<float> taps = gr::filter::firdes::low_pass(flt_size, _samp_rate, _filter_width, 12000);
+    std::vector<float> taps = gr_taps_cache::low_pass(flt_size, _samp_rate, _filter_width, 12000);
     _resampler = gr::filter::rational_resampler_base_ccf::make(1, 50, taps);
     _agc = gr::analog::agc2_cc::make(0.006e-1, 1e-3, 1, 1);
     _freq_transl_filter = gr::filter::freq_xlating_fir_filter_ccf::make(
-                1,gr::filter::firdes::low_pass(
+                1,gr_taps_cache::low_pass(
                     1, _target_samp_rate, 2*_filter_width ,250000, gr::filter::firdes::WIN_HAMMING), 25000,
                 _target_samp_rate);
-    _filter = gr::filter::fft_filter_ccf::make(1, gr::filter::firdes::low_pass(
+    _filter = gr::filter::fft_filter_ccf::make(1, gr_taps_cache::low_pass(
                             1, _target_samp_rate, _filter_width,600,gr::filter::firdes::WIN_HAMMING) );
     float gain_mu = 0.025;
     _clock_recovery = gr::digital::clock_recovery_mm_cc::make(_samples_per_symbol, 0.025*gain_mu*gain_mu, 0.5, gain_mu,
                                                               0.001);
     _costas_loop = gr::digital::costas_loop_cc::make(0.0628,2);
     _equalizer = gr::digital::cma_equalizer_cc::make(8,2,0.00005,1);
-    _fll = gr::digital::fll_band_edge_cc::make(sps, 0.35, 32, 0.000628);
+    _fll = gr::digital::fll_band_edge_cc::make(_samples_per_symbol, 0.35, 32, 0.000628);
     _complex_to_real = gr::blocks::complex_to_real::make();
     _binary_slicer = gr::digital::binary_slicer_fb::make();
     _packed_to_unpacked = gr::blocks::packed_to_unpacked_bb::make(1,gr::GR_MSB_FIRST);
@@ -84,9 +84,9 @@ gr_demod_bpsk_sdr::gr_demod_bpsk_sdr(std::vector<int>signature, int sps, int sam
     connect(_resampler,0,_filter,0);
     connect(_filter,0,self(),0);
     connect(_filter,0,_agc,0);
-    connect(_agc,0,_clock_recovery,0);
+    connect(_agc,0,_fll,0);
+    connect(_fll,0,_clock_recovery,0);
     connect(_clock_recovery,0,_equalizer,0);
-    //connect(_fll,0,_clock_recovery,0);
 
     connect(_equalizer,0,_costas_loop,0);
     connect(_costas_loop,0,_complex_to_real,0);
@@ -117,3 +117,8 @@ std::vector<unsigned char>* gr_demod_bpsk_sdr::getFrame2()
     return data;
 }
 
+void gr_demod_bpsk_sdr::set_frame_length(int frame_length, int voice_frames)
+{
+    _deframer1->set_frame_length(frame_length, voice_frames);
+    _deframer2->set_frame_length(frame_length, voice_frames);
+}
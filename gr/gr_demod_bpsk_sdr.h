@@ -41,6 +41,7 @@
 #include <gnuradio/blocks/delay.h>
 #include <gnuradio/blocks/multiply_const_ff.h>
 #include "gr_deframer_bb.h"
+#include "gr_taps_cache.h"
 
 class gr_demod_bpsk_sdr;
 
@@ -55,6 +56,7 @@ public:
                                int filter_width=1800, int mode=1);
     std::vector<unsigned char> *getFrame1();
     std::vector<unsigned char> *getFrame2();
+    void set_frame_length(int frame_length, int voice_frames);
 
 private:
 
@@ -49,15 +49,15 @@ gr_demod_nbfm_sdr::gr_demod_nbfm_sdr(std::vector<int>signature, int sps, int sam
     _deemphasis_filter = gr::filter::fft_filter_fff::make(1,iir_taps);
 
     _audio_filter = gr::filter::fft_filter_fff::make(
-                1,gr::filter::firdes::high_pass(
+                1,gr_taps_cache::high_pass(
                     1, _target_samp_rate, 300, 50, gr::filter::firdes::WIN_BLACKMAN_HARRIS));
 
-    std::vector<float> taps = gr::filter::firdes::low_pass(1, _samp_rate, _filter_width, 10000);
-    std::vector<float> audio_taps = gr::filter::firdes::low_pass(1, _target_samp_rate, _filter_width, 2000);
+    std::vector<float> taps = gr_taps_cache::low_pass(1, _samp_rate, _filter_width, 10000);
+    std::vector<float> audio_taps = gr_taps_cache::low_pass(1, _target_samp_rate, _filter_width, 2000);
     _resampler = gr::filter::rational_resampler_base_ccf::make(4,100, taps);
     _audio_resampler = gr::filter::rational_resampler_base_fff::make(1,5, audio_taps);
 
-    _filter = gr::filter::fft_filter_ccf::make(1, gr::filter::firdes::low_pass(
+    _filter = gr::filter::fft_filter_ccf::make(1, gr_taps_cache::low_pass(
                             1, _target_samp_rate, _filter_width,600,gr::filter::firdes::WIN_HAMMING) );
 
     _fm_demod = gr::analog::quadrature_demod_cf::make(_target_samp_rate/(4*M_PI* _filter_width));
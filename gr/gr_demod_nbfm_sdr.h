@@ -29,6 +29,7 @@
 #include <gnuradio/filter/fft_filter_fff.h>
 #include <gnuradio/blocks/float_to_short.h>
 #include <gnuradio/blocks/multiply_const_ff.h>
+#include "gr_taps_cache.h"
 
 
 class gr_demod_nbfm_sdr;
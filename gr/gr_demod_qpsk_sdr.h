@@ -37,6 +37,7 @@
 #include <gnuradio/digital/pfb_clock_sync_ccf.h>
 #include <gnuradio/filter/fft_filter_ccf.h>
 #include <gnuradio/digital/descrambler_bb.h>
+#include "gr_taps_cache.h"
 
 
 class gr_demod_qpsk_sdr;
@@ -26,6 +26,7 @@
 #include <gnuradio/filter/fft_filter_ccc.h>
 #include <gnuradio/blocks/complex_to_real.h>
 #include <gnuradio/blocks/multiply_const_ff.h>
+#include "gr_taps_cache.h"
 
 
 class gr_demod_ssb_sdr;
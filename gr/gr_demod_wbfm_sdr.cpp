@@ -51,15 +51,15 @@ gr_demod_wbfm_sdr::gr_demod_wbfm_sdr(std::vector<int>signature, int sps, int sam
     std::vector<float> iir_taps(coeff, coeff + sizeof(coeff) / sizeof(coeff[0]) );
     _deemphasis_filter = gr::filter::fft_filter_fff::make(1,iir_taps);
 
-    std::vector<float> taps = gr::filter::firdes::low_pass(1, _samp_rate, _filter_width, 12000);
-    std::vector<float> audio_taps = gr::filter::firdes::low_pass(1, _target_samp_rate, 4000, 600);
+    std::vector<float> taps = gr_taps_cache::low_pass(1, _samp_rate, _filter_width, 12000);
+    std::vector<float> audio_taps = gr_taps_cache::low_pass(1, _target_samp_rate, 4000, 600);
     _resampler = gr::filter::rational_resampler_base_ccf::make(1,5,taps);
     _audio_resampler = gr::filter::pfb_arb_resampler_fff::make(rerate, audio_taps, flt_size);
 
-    _filter = gr::filter::fft_filter_ccf::make(1, gr::filter::firdes::low_pass(
+    _filter = gr::filter::fft_filter_ccf::make(1, gr_taps_cache::low_pass(
                             1, _target_samp_rate, _filter_width,600,gr::filter::firdes::WIN_HAMMING) );
 
-    _pilot_filter = gr::filter::fft_filter_fff::make(1,gr::filter::firdes::low_pass(
+    _pilot_filter = gr::filter::fft_filter_fff::make(1,gr_taps_cache::low_pass(
                                                          1,_target_samp_rate,4000,
                                                          600,gr::filter::firdes::WIN_HAMMING));
     _fm_demod = gr::analog::quadrature_demod_cf::make(_target_samp_rate/(2*M_PI* _filter_width));
@@ -27,6 +27,7 @@
 #include <gnuradio/filter/fft_filter_ccf.h>
 #include <gnuradio/filter/fft_filter_fff.h>
 #include <gnuradio/blocks/multiply_const_ff.h>
+#include "gr_taps_cache.h"
 
 
 class gr_demod_wbfm_sdr;
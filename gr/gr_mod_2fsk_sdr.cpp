@@ -51,7 +51,7 @@ gr_mod_2fsk_sdr::gr_mod_2fsk_sdr(int sps, int samp_rate, int carrier_freq,
     _repeat = gr::blocks::repeat::make(4, _samples_per_symbol);
     _amplify = gr::blocks::multiply_const_cc::make(0.3,1);
     _filter = gr::filter::fft_filter_ccf::make(
-                1,gr::filter::firdes::low_pass(
+                1,gr_taps_cache::low_pass(
                     1, _samp_rate, _filter_width, 600,gr::filter::firdes::WIN_HAMMING));
 
     connect(self(),0,_packed_to_unpacked,0);
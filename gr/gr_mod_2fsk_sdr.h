@@ -37,6 +37,7 @@
 #include <gnuradio/digital/constellation.h>
 #include <gnuradio/analog/frequency_modulator_fc.h>
 #include <gnuradio/fec/encode_ccsds_27_bb.h>
+#include "gr_taps_cache.h"
 
 class gr_mod_2fsk_sdr;
 
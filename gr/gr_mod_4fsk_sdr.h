@@ -37,6 +37,7 @@
 #include <gnuradio/blocks/pack_k_bits_bb.h>
 #include <gnuradio/filter/fft_filter_ccf.h>
 #include <gnuradio/analog/frequency_modulator_fc.h>
+#include "gr_taps_cache.h"
 
 
 class gr_mod_4fsk_sdr;
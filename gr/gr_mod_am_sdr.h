@@ -29,6 +29,7 @@
 #include <gnuradio/analog/sig_source_c.h>
 #include <gnuradio/blocks/float_to_complex.h>
 #include <gnuradio/blocks/delay.h>
+#include "gr_taps_cache.h"
 
 class gr_mod_am_sdr;
 
@@ -27,7 +27,8 @@ gr_mod_base::gr_mod_base(QObject *parent, float device_frequency, float rf_gain,
     _audio_source = make_gr_audio_source();
 
     _osmosdr_sink = osmosdr::sink::make(device_args);
-    _osmosdr_sink->set_sample_rate(250000);
+    _samp_rate = 250000;
+    _osmosdr_sink->set_sample_rate(_samp_rate);
     _osmosdr_sink->set_antenna(device_antenna);
     _osmosdr_sink->set_center_freq(_device_frequency);
     _osmosdr_sink->set_freq_corr(freq_corr);
@@ -51,143 +52,76 @@ gr_mod_base::gr_mod_base(QObject *parent, float device_frequency, float rf_gain,
     _qpsk_250k = make_gr_mod_qpsk_sdr(2, 250000, 1700, 65000);
     _qpsk_video = make_gr_mod_qpsk_sdr(2, 250000, 1700, 65000);
     _ssb = make_gr_mod_ssb_sdr(0, 250000, 1700, 2500);
+
+    // all modulators stay connected, set_mode only moves the input valves
+    // and the output selector
+    _tx_select = make_gr_mode_selector(sizeof(gr_complex), 16);
+    _tx_inputs = 0;
+    // the flowgraph keeps running while TX is enabled and the gate keys it,
+    // its small output buffer bounds the keying delay to a few milliseconds.
+    // UHD devices get tx_sob/tx_eob tags and stop sending between bursts.
+    // Closing waits for 100 ms without modulated samples
+    _tx_burst = device_args.find("uhd") != std::string::npos;
+    _tx_gate = make_gr_tx_gate_cc(_tx_burst, _samp_rate / 10);
+    _tx_gate->set_max_output_buffer(4096);
+    _top_block->connect(_tx_select,0,_tx_gate,0);
+    _top_block->connect(_tx_gate,0,_osmosdr_sink,0);
+
+    add_tx_chain(gr_modem_types::ModemType2FSK2000, _2fsk, 500000, false);
+    add_tx_chain(gr_modem_types::ModemType4FSK2000, _4fsk_2k, 250000, false);
+    add_tx_chain(gr_modem_types::ModemType4FSK20000, _4fsk_10k, 250000, false);
+    add_tx_chain(gr_modem_types::ModemTypeAM5000, _am, 250000, true);
+    add_tx_chain(gr_modem_types::ModemTypeBPSK1000, _bpsk_1k, 500000, false);
+    add_tx_chain(gr_modem_types::ModemTypeBPSK2000, _bpsk_2k, 500000, false);
+    add_tx_chain(gr_modem_types::ModemTypeNBFM2500, _fm_2500, 250000, true);
+    add_tx_chain(gr_modem_types::ModemTypeNBFM5000, _fm_5000, 250000, true);
+    add_tx_chain(gr_modem_types::ModemTypeQPSK2000, _qpsk_2k, 250000, false);
+    add_tx_chain(gr_modem_types::ModemTypeQPSK20000, _qpsk_10k, 250000, false);
+    add_tx_chain(gr_modem_types::ModemTypeQPSK250000, _qpsk_250k, 250000, false);
+    add_tx_chain(gr_modem_types::ModemTypeQPSKVideo, _qpsk_video, 250000, false);
+    add_tx_chain(gr_modem_types::ModemTypeSSB2500, _ssb, 250000, true);
 }
 
-void gr_mod_base::set_mode(int mode)
+void gr_mod_base::add_tx_chain(int mode, gr::basic_block_sptr mod, int samp_rate, bool audio)
 {
-    _top_block->lock();
-
-    switch(_mode)
+    tx_chain chain;
+    chain.samp_rate = samp_rate;
+    chain.input = _tx_inputs++;
+    if(audio)
     {
-    case gr_modem_types::ModemType2FSK2000:
-        _top_block->disconnect(_vector_source,0,_2fsk,0);
-        _top_block->disconnect(_2fsk,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemType4FSK2000:
-        _top_block->disconnect(_vector_source,0,_4fsk_2k,0);
-        _top_block->disconnect(_4fsk_2k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemType4FSK20000:
-        _top_block->disconnect(_vector_source,0,_4fsk_10k,0);
-        _top_block->disconnect(_4fsk_10k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeAM5000:
-        _top_block->disconnect(_audio_source,0,_am,0);
-        _top_block->disconnect(_am,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeBPSK1000:
-        _top_block->disconnect(_vector_source,0,_bpsk_1k,0);
-        _top_block->disconnect(_bpsk_1k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeBPSK2000:
-        _top_block->disconnect(_vector_source,0,_bpsk_2k,0);
-        _top_block->disconnect(_bpsk_2k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeNBFM2500:
-        _top_block->disconnect(_audio_source,0,_fm_2500,0);
-        _top_block->disconnect(_fm_2500,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeNBFM5000:
-        _top_block->disconnect(_audio_source,0,_fm_5000,0);
-        _top_block->disconnect(_fm_5000,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSK2000:
-        _top_block->disconnect(_vector_source,0,_qpsk_2k,0);
-        _top_block->disconnect(_qpsk_2k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSK20000:
-        _top_block->disconnect(_vector_source,0,_qpsk_10k,0);
-        _top_block->disconnect(_qpsk_10k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSK250000:
-        _top_block->disconnect(_vector_source,0,_qpsk_250k,0);
-        _top_block->disconnect(_qpsk_250k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSKVideo:
-        _top_block->disconnect(_vector_source,0,_qpsk_video,0);
-        _top_block->disconnect(_qpsk_video,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeSSB2500:
-        _top_block->disconnect(_audio_source,0,_ssb,0);
-        _top_block->disconnect(_ssb,0,_osmosdr_sink,0);
-        break;
-    default:
-        break;
+        chain.valve = gr::blocks::copy::make(sizeof(float));
+        _top_block->connect(_audio_source,0,chain.valve,0);
     }
-
-    switch(mode)
+    else
     {
-    case gr_modem_types::ModemType2FSK2000:
-        _osmosdr_sink->set_sample_rate(500000);
-        _top_block->connect(_vector_source,0,_2fsk,0);
-        _top_block->connect(_2fsk,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemType4FSK2000:
-        _osmosdr_sink->set_sample_rate(250000);
-        _top_block->connect(_vector_source,0,_4fsk_2k,0);
-        _top_block->connect(_4fsk_2k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemType4FSK20000:
-        _osmosdr_sink->set_sample_rate(250000);
-        _top_block->connect(_vector_source,0,_4fsk_10k,0);
-        _top_block->connect(_4fsk_10k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeAM5000:
-        _osmosdr_sink->set_sample_rate(250000);
-        _top_block->connect(_audio_source,0,_am,0);
-        _top_block->connect(_am,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeBPSK1000:
-        _osmosdr_sink->set_sample_rate(500000);
-        _top_block->connect(_vector_source,0,_bpsk_1k,0);
-        _top_block->connect(_bpsk_1k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeBPSK2000:
-        _osmosdr_sink->set_sample_rate(500000);
-        _top_block->connect(_vector_source,0,_bpsk_2k,0);
-        _top_block->connect(_bpsk_2k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeNBFM2500:
-        _osmosdr_sink->set_sample_rate(250000);
-        _top_block->connect(_audio_source,0,_fm_2500,0);
-        _top_block->connect(_fm_2500,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeNBFM5000:
-        _osmosdr_sink->set_sample_rate(250000);
-        _top_block->connect(_audio_source,0,_fm_5000,0);
-        _top_block->connect(_fm_5000,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSK2000:
-        _osmosdr_sink->set_sample_rate(250000);
-        _top_block->connect(_vector_source,0,_qpsk_2k,0);
-        _top_block->connect(_qpsk_2k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSK20000:
-        _osmosdr_sink->set_sample_rate(250000);
-        _top_block->connect(_vector_source,0,_qpsk_10k,0);
-        _top_block->connect(_qpsk_10k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSK250000:
-        _osmosdr_sink->set_sample_rate(250000);
-        _top_block->connect(_vector_source,0,_qpsk_250k,0);
-        _top_block->connect(_qpsk_250k,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeQPSKVideo:
-        _osmosdr_sink->set_sample_rate(250000);
-        _top_block->connect(_vector_source,0,_qpsk_video,0);
-        _top_block->connect(_qpsk_video,0,_osmosdr_sink,0);
-        break;
-    case gr_modem_types::ModemTypeSSB2500:
-        _osmosdr_sink->set_sample_rate(250000);
-        _top_block->connect(_audio_source,0,_ssb,0);
-        _top_block->connect(_ssb,0,_osmosdr_sink,0);
-        break;
-    default:
-        break;
+        chain.valve = gr::blocks::copy::make(sizeof(unsigned char));
+        _top_block->connect(_vector_source,0,chain.valve,0);
     }
+    chain.valve->set_enabled(false);
+    _top_block->connect(chain.valve,0,mod,0);
+    _top_block->connect(mod,0,_tx_select,chain.input);
+    _tx_chains[mode] = chain;
+}
+
+void gr_mod_base::set_mode(int mode)
+{
+    std::map<int, tx_chain>::iterator current = _tx_chains.find(_mode);
+    if(current != _tx_chains.end())
+        current->second.valve->set_enabled(false);
     _mode = mode;
+    std::map<int, tx_chain>::iterator next = _tx_chains.find(mode);
+    if(next == _tx_chains.end())
+        return;
 
-    _top_block->unlock();
+    const tx_chain &chain = next->second;
+    if(chain.samp_rate != _samp_rate)
+    {
+        _samp_rate = chain.samp_rate;
+        _osmosdr_sink->set_sample_rate(_samp_rate);
+        _tx_gate->set_drain(_samp_rate / 10);
+    }
+    _tx_select->set_input_index(chain.input);
+    chain.valve->set_enabled(true);
 }
 
 void gr_mod_base::start()
@@ -206,12 +140,34 @@ int gr_mod_base::setData(std::vector<u_int8_t> *data)
     return _vector_source->set_data(data);
 }
 
-int gr_mod_base::setAudio(std::vector<float> *data)
+int gr_mod_base::setAudio(const float *data, int size)
 {
-    return _audio_source->set_data(data);
+    return _audio_source->set_data(data, size);
 
 }
 
+void gr_mod_base::set_tx_gate(bool open)
+{
+    _tx_gate->set_open(open);
+}
+
+bool gr_mod_base::tx_gate_open()
+{
+    return _tx_gate->is_open();
+}
+
+/// Nothing left in the sources, the modulators may still be draining
+bool gr_mod_base::tx_idle()
+{
+    return _vector_source->is_idle() && _audio_source->is_idle();
+}
+
+/// True if the device is sent bursts and nothing between them
+bool gr_mod_base::tx_burst_mode()
+{
+    return _tx_burst;
+}
+
 void gr_mod_base::tune(long center_freq)
 {
     _device_frequency = center_freq;
@@ -22,6 +22,8 @@
 #include <gnuradio/top_block.h>
 #include <osmosdr/sink.h>
 #include <vector>
+#include <map>
+#include <gnuradio/blocks/copy.h>
 #include "gr_vector_source.h"
 #include "gr_audio_source.h"
 #include "gr_mod_2fsk_sdr.h"
@@ -31,6 +33,8 @@
 #include "gr_mod_nbfm_sdr.h"
 #include "gr_mod_qpsk_sdr.h"
 #include "gr_mod_ssb_sdr.h"
+#include "gr_mode_selector.h"
+#include "gr_tx_gate_cc.h"
 
 class gr_mod_base : public QObject
 {
@@ -47,9 +51,21 @@ public slots:
     void set_power(float dbm);
     void set_ctcss(float value);
     void set_mode(int mode);
-    int setAudio(std::vector<float> *data);
+    int setAudio(const float *data, int size);
+    void set_tx_gate(bool open);
+    bool tx_gate_open();
+    bool tx_idle();
+    bool tx_burst_mode();
 
 private:
+    struct tx_chain
+    {
+        gr::blocks::copy::sptr valve;
+        int input;
+        int samp_rate;
+    };
+    void add_tx_chain(int mode, gr::basic_block_sptr mod, int samp_rate, bool audio);
+
     gr::top_block_sptr _top_block;
     gr_vector_source_sptr _vector_source;
     gr_audio_source_sptr _audio_source;
@@ -68,6 +84,11 @@ private:
     gr_mod_qpsk_sdr_sptr _qpsk_250k;
     gr_mod_qpsk_sdr_sptr _qpsk_video;
     gr_mod_ssb_sdr_sptr _ssb;
+    gr_mode_selector_sptr _tx_select;
+    gr_tx_gate_cc_sptr _tx_gate;
+    bool _tx_burst;
+    std::map<int, tx_chain> _tx_chains;
+    int _tx_inputs;
 
     int _samples_per_symbol;
     int _samp_rate;
@@ -50,13 +50,13 @@ gr_mod_bpsk_sdr::gr_mod_bpsk_sdr(int sps, int samp_rate, int carrier_freq,
 
     _chunks_to_symbols = gr::digital::chunks_to_symbols_bc::make(constellation);
     int nfilts = 32;
-    std::vector<float> rrc_taps = gr::filter::firdes::root_raised_cosine(nfilts, nfilts,
+    std::vector<float> rrc_taps = gr_taps_cache::root_raised_cosine(nfilts, nfilts,
                                                         1, 0.35, nfilts * 11 * _samples_per_symbol);
     _shaping_filter = gr::filter::pfb_arb_resampler_ccf::make(_samples_per_symbol, rrc_taps, nfilts);
     _repeat = gr::blocks::repeat::make(8, _samples_per_symbol);
     _amplify = gr::blocks::multiply_const_cc::make(0.3,1);
     _filter = gr::filter::fft_filter_ccf::make(
-                1,gr::filter::firdes::low_pass(
+                1,gr_taps_cache::low_pass(
                     1, _samp_rate, _filter_width, 600, gr::filter::firdes::WIN_HAMMING));
 
 
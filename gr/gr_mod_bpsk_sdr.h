@@ -36,6 +36,7 @@
 #include <gnuradio/digital/scrambler_bb.h>
 #include <gnuradio/fec/encode_ccsds_27_bb.h>
 #include <gnuradio/filter/fft_filter_ccf.h>
+#include "gr_taps_cache.h"
 
 
 class gr_mod_bpsk_sdr;
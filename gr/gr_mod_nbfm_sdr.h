@@ -31,6 +31,7 @@
 #include <gnuradio/blocks/multiply_ff.h>
 #include <gnuradio/analog/sig_source_f.h>
 #include <gnuradio/analog/agc2_ff.h>
+#include "gr_taps_cache.h"
 
 
 class gr_mod_nbfm_sdr;
@@ -37,6 +37,7 @@
 #include <gnuradio/blocks/pack_k_bits_bb.h>
 #include <gnuradio/filter/fft_filter_ccf.h>
 #include <gnuradio/digital/constellation.h>
+#include "gr_taps_cache.h"
 
 
 class gr_mod_qpsk_sdr;
@@ -42,16 +42,16 @@ gr_mod_ssb_sdr::gr_mod_ssb_sdr(int sps, int samp_rate, int carrier_freq,
     _multiply = gr::blocks::multiply_ff::make();
     _multiply2 = gr::blocks::multiply_cc::make();
     _audio_filter = gr::filter::fft_filter_fff::make(
-                1,gr::filter::firdes::low_pass(
+                1,gr_taps_cache::low_pass(
                     1, target_samp_rate, _filter_width, 600, gr::filter::firdes::WIN_HAMMING));
     _float_to_complex = gr::blocks::float_to_complex::make();
-    std::vector<float> interp_taps = gr::filter::firdes::low_pass(1, target_samp_rate,
+    std::vector<float> interp_taps = gr_taps_cache::low_pass(1, target_samp_rate,
                                                         4000, 4000);
     float rerate = (float)_samp_rate/target_samp_rate;
     _resampler = gr::filter::pfb_arb_resampler_ccf::make(rerate, interp_taps, 16);
     _amplify = gr::blocks::multiply_const_cc::make(80,1);
     _filter = gr::filter::fft_filter_ccc::make(
-                1,gr::filter::firdes::complex_band_pass_2(
+                1,gr_taps_cache::complex_band_pass_2(
                     1, _samp_rate, 400, _filter_width, 10, 120, gr::filter::firdes::WIN_BLACKMAN_HARRIS));
 
 
@@ -0,0 +1,78 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#include "gr_mode_selector.h"
+
+gr_mode_selector_sptr make_gr_mode_selector(size_t itemsize, int ninputs)
+{
+    return gnuradio::get_initial_sptr(new gr_mode_selector(itemsize, ninputs));
+}
+
+gr_mode_selector::gr_mode_selector(size_t itemsize, int ninputs) :
+    gr::block("gr_mode_selector",
+              gr::io_signature::make (1, ninputs, itemsize),
+              gr::io_signature::make (1, 1, itemsize))
+{
+    _itemsize = itemsize;
+    _ninputs = ninputs;
+    _active = 0;
+}
+
+void gr_mode_selector::set_input_index(int index)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    if((index >= 0) && (index < _ninputs))
+        _active = index;
+}
+
+int gr_mode_selector::input_index()
+{
+    gr::thread::scoped_lock guard(_mutex);
+    return _active;
+}
+
+void gr_mode_selector::forecast(int noutput_items, gr_vector_int &ninput_items_required)
+{
+    int active = input_index();
+    for(unsigned int i=0;i<ninput_items_required.size();i++)
+    {
+        ninput_items_required[i] = ((int)i == active) ? noutput_items : 0;
+    }
+}
+
+int gr_mode_selector::general_work(int noutput_items,
+                                   gr_vector_int &ninput_items,
+                                   gr_vector_const_void_star &input_items,
+                                   gr_vector_void_star &output_items)
+{
+    int active = input_index();
+    int produced = 0;
+    for(unsigned int i=0;i<input_items.size();i++)
+    {
+        if((int)i == active)
+        {
+            produced = std::min(noutput_items, ninput_items[i]);
+            memcpy(output_items[0], input_items[i], produced * _itemsize);
+            consume(i, produced);
+        }
+        else
+        {
+            consume(i, ninput_items[i]);
+        }
+    }
+    return produced;
+}
@@ -0,0 +1,59 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#ifndef GR_MODE_SELECTOR_H
+#define GR_MODE_SELECTOR_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <string.h>
+#include <algorithm>
+
+class gr_mode_selector;
+typedef boost::shared_ptr<gr_mode_selector> gr_mode_selector_sptr;
+
+gr_mode_selector_sptr make_gr_mode_selector(size_t itemsize, int ninputs);
+
+/**
+ * @brief Forwards one of several always connected inputs to the output.
+ *
+ * Only the active input is waited for, anything arriving on the other
+ * inputs is consumed and dropped so the chains behind them never stall.
+ * Switching the active input does not require locking the flowgraph.
+ */
+class gr_mode_selector : public gr::block
+{
+public:
+    gr_mode_selector(size_t itemsize, int ninputs);
+
+    void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+    int general_work(int noutput_items,
+                     gr_vector_int &ninput_items,
+                     gr_vector_const_void_star &input_items,
+                     gr_vector_void_star &output_items);
+
+    void set_input_index(int index);
+    int input_index();
+
+private:
+    size_t _itemsize;
+    int _ninputs;
+    int _active;
+    gr::thread::mutex _mutex;
+};
+
+#endif // GR_MODE_SELECTOR_H
@@ -16,13 +16,14 @@
 
 #include "gr_modem.h"
 
-gr_modem::gr_modem(Settings *settings, gr::qtgui::sink_c::sptr fft_gui, gr::qtgui::const_sink_c::sptr const_gui,
+gr_modem::gr_modem(Settings *settings, gr::qtgui::vector_sink_f::sptr fft_gui, gr::qtgui::const_sink_c::sptr const_gui,
                    gr::qtgui::number_sink::sptr rssi_gui, QObject *parent) :
     QObject(parent)
 {
     _modem_type_rx = gr_modem_types::ModemTypeBPSK2000;
     _modem_type_tx = gr_modem_types::ModemTypeBPSK2000;
     _repeater = false;
+    _repeater_queue = new gr_repeater(settings->_repeater_hold_time);
     _settings = settings;
     _transmitting = false;
     //_gr_mod_gmsk = new gr_mod_gmsk(0,24,48000,1600,1200,1);
@@ -35,8 +36,10 @@ gr_modem::gr_modem(Settings *settings, gr::qtgui::sink_c::sptr fft_gui, gr::qtgu
     //_gr_demod_bpsk->start();
     _rx_frame_length = 7;
     _tx_frame_length = 7;
+    _rx_voice_frames = 1;
     _bit_buf_len = 8 *8;
-    _bit_buf = new unsigned char[_bit_buf_len];
+    _bit_buf_size = _bit_buf_len;
+    _bit_buf = new unsigned char[_bit_buf_size];
     _bit_buf_index = 0;
     _sync_found = false;
     _frame_counter = 0;
@@ -56,6 +59,7 @@ gr_modem::gr_modem(Settings *settings, gr::qtgui::sink_c::sptr fft_gui, gr::qtgu
 
 gr_modem::~gr_modem()
 {
+    delete _repeater_queue;
     //deinitRX();
     //deinitTX();
 }
@@ -63,7 +67,9 @@ gr_modem::~gr_modem()
 void gr_modem::initTX(int modem_type, std::string device_args, std::string device_antenna, int freq_corr)
 {
     _modem_type_tx = modem_type;
+    loadFilterTaps();
     _gr_mod_base = new gr_mod_base(0, _requested_frequency_hz, 0.5, device_args, device_antenna, freq_corr);
+    saveFilterTaps();
     toggleTxMode(modem_type);
 
 }
@@ -71,54 +77,65 @@ void gr_modem::initTX(int modem_type, std::string device_args, std::string devic
 void gr_modem::initRX(int modem_type, std::string device_args, std::string device_antenna, int freq_corr)
 {
     _modem_type_rx = modem_type;
+    loadFilterTaps();
     _gr_demod_base = new gr_demod_base(_fft_gui,
                 _const_gui, _rssi_gui, 0, _requested_frequency_hz, 0.9, device_args, device_antenna, freq_corr);
+    _gr_demod_base->set_spectrum_params(_settings->_spectrum_frame_rate, _settings->_spectrum_averaging);
+    saveFilterTaps();
     toggleRxMode(modem_type);
 
 }
 
+void gr_modem::loadFilterTaps()
+{
+    static bool loaded = false;
+    if(loaded || !_settings->_cache_filter_taps)
+        return;
+    loaded = true;
+    QString path = QDir::homePath() + "/.config/qradiolink_taps.bin";
+    gr_taps_cache::load(path.toStdString());
+}
+
+void gr_modem::saveFilterTaps()
+{
+    if(!_settings->_cache_filter_taps || !gr_taps_cache::is_dirty())
+        return;
+    QString path = QDir::homePath() + "/.config/qradiolink_taps.bin";
+    gr_taps_cache::save(path.toStdString());
+}
+
+/// Number of Codec2 frames sent behind one sync word, both ends must agree
+int gr_modem::voiceFrames(int modem_type)
+{
+    const gr_modem_types::modem_info *modem = gr_modem_types::get_modem_info(modem_type);
+    // BPSK1000 frames have no reserved byte and keep one vocoder frame each
+    if(modem && (modem->codec == gr_modem_types::CodecCodec2)
+            && (modem_type != gr_modem_types::ModemTypeBPSK1000))
+        return std::max(1, std::min(8, _settings->_codec2_superframe));
+    return 1;
+}
+
+/// Vocoder mode in use for a Codec2 modem, the table default unless the best fit is enabled
+int gr_modem::codec2Mode(int modem_type)
+{
+    const gr_modem_types::modem_info *modem = gr_modem_types::get_modem_info(modem_type);
+    if(!modem || (modem->codec != gr_modem_types::CodecCodec2))
+        return -1;
+    if(_settings->_codec2_best_mode)
+        return gr_modem_types::best_codec2_mode(modem_type, voiceFrames(modem_type));
+    return modem->codec2_mode;
+}
+
 void gr_modem::toggleTxMode(int modem_type)
 {
+    _tx_voice_frames.clear();
     _modem_type_tx = modem_type;
     if(_gr_mod_base)
     {
         _gr_mod_base->set_mode(modem_type);
-        if(modem_type == gr_modem_types::ModemTypeBPSK2000)
-        {
-            _tx_frame_length = 7;
-        }
-        else if(modem_type == gr_modem_types::ModemTypeBPSK1000)
-        {
-            _tx_frame_length = 4;
-        }
-        else if(modem_type == gr_modem_types::ModemTypeQPSK20000)
-        {
-            _tx_frame_length = 47;
-        }
-        else if(modem_type == gr_modem_types::ModemTypeQPSK2000)
-        {
-            _tx_frame_length = 7;
-        }
-        else if(modem_type == gr_modem_types::ModemType4FSK20000)
-        {
-            _tx_frame_length = 47;
-        }
-        else if(modem_type == gr_modem_types::ModemType4FSK2000)
-        {
-            _tx_frame_length = 7;
-        }
-        else if(modem_type == gr_modem_types::ModemTypeQPSKVideo)
-        {
-            _tx_frame_length = 3122;
-        }
-        else if(modem_type == gr_modem_types::ModemType2FSK2000)
-        {
-            _tx_frame_length = 7;
-        }
-        else if(modem_type == gr_modem_types::ModemTypeQPSK250000)
-        {
-            _tx_frame_length = 1512;
-        }
+        int frame_length = gr_modem_types::frame_length(modem_type, codec2Mode(modem_type));
+        if(frame_length > 0)
+            _tx_frame_length = frame_length;
     }
 
 }
@@ -129,53 +146,19 @@ void gr_modem::toggleRxMode(int modem_type)
     if(_gr_demod_base)
     {
         _gr_demod_base->set_mode(modem_type);
-        if(modem_type == gr_modem_types::ModemTypeBPSK2000)
-        {
-            _bit_buf_len = 8 *8;
-            _rx_frame_length = 7;
-        }
-        else if(modem_type == gr_modem_types::ModemTypeBPSK1000)
-        {
-            _bit_buf_len = 4 *8;
-            _rx_frame_length = 4;
-        }
-        else if (modem_type == gr_modem_types::ModemTypeQPSK20000)
+        const gr_modem_types::modem_info *modem = gr_modem_types::get_modem_info(modem_type);
+        int frame_length = gr_modem_types::frame_length(modem_type, codec2Mode(modem_type));
+        if(frame_length > 0)
         {
-            _bit_buf_len = 48 *8;
-            _rx_frame_length = 47;
-        }
-        else if (modem_type == gr_modem_types::ModemTypeQPSK2000)
-        {
-            _bit_buf_len = 8 *8;
-            _rx_frame_length = 7;
-        }
-        else if (modem_type == gr_modem_types::ModemType4FSK20000)
-        {
-            _bit_buf_len = 48 *8;
-            _rx_frame_length = 47;
-        }
-        else if (modem_type == gr_modem_types::ModemType4FSK2000)
-        {
-            _bit_buf_len = 8 *8;
-            _rx_frame_length = 7;
-        }
-        else if (modem_type == gr_modem_types::ModemTypeQPSKVideo)
-        {
-            _bit_buf_len = 3123 *8;
-            _rx_frame_length = 3122;
-        }
-        else if(modem_type == gr_modem_types::ModemType2FSK2000)
-        {
-            _bit_buf_len = 8 *8;
-            _rx_frame_length = 7;
-        }
-        else if (modem_type == gr_modem_types::ModemTypeQPSK250000)
-        {
-            _bit_buf_len = 1513 *8;
-            _rx_frame_length = 1512;
+            _rx_frame_length = frame_length;
+            _bit_buf_len = (_rx_frame_length + modem->frame_start_bytes) * 8;
         }
+        _rx_voice_frames = voiceFrames(modem_type);
+        _gr_demod_base->set_frame_length(modem_type, _rx_frame_length, _rx_voice_frames);
+        // voice superframes are the longest frames in the codec2 modes
+        _bit_buf_size = std::max(_bit_buf_len, (_rx_frame_length * _rx_voice_frames + 1) * 8);
         delete[] _bit_buf;
-        _bit_buf = new unsigned char[_bit_buf_len];
+        _bit_buf = new unsigned char[_bit_buf_size];
     }
 }
 
@@ -216,6 +199,34 @@ void gr_modem::stopTX()
     _gr_mod_base->stop();
 }
 
+/// Keys the running transmitter, closing waits for the modulator to drain
+void gr_modem::setTxGate(bool open)
+{
+    if(_gr_mod_base)
+        _gr_mod_base->set_tx_gate(open);
+}
+
+bool gr_modem::txIdle()
+{
+    if(!_gr_mod_base)
+        return true;
+    return _gr_mod_base->tx_idle();
+}
+
+bool gr_modem::txGateOpen()
+{
+    if(!_gr_mod_base)
+        return false;
+    return _gr_mod_base->tx_gate_open();
+}
+
+bool gr_modem::txBurstMode()
+{
+    if(!_gr_mod_base)
+        return false;
+    return _gr_mod_base->tx_burst_mode();
+}
+
 double gr_modem::getFreqGUI()
 {
     if(_gr_demod_base)
@@ -223,6 +234,46 @@ double gr_modem::getFreqGUI()
     return 0;
 }
 
+float gr_modem::getRSSI()
+{
+    if(_gr_demod_base)
+        return _gr_demod_base->get_rssi();
+    return -200.0;
+}
+
+void gr_modem::enableSpectrumAnalysis(bool value)
+{
+    if(_gr_demod_base)
+        _gr_demod_base->enable_spectrum_analysis(value);
+}
+
+bool gr_modem::getSpectrum(std::vector<float> &frame)
+{
+    if(_gr_demod_base)
+        return _gr_demod_base->get_spectrum(frame);
+    return false;
+}
+
+quint64 gr_modem::getSpectrumFrames()
+{
+    if(_gr_demod_base)
+        return _gr_demod_base->get_spectrum_frames();
+    return 0;
+}
+
+void gr_modem::startCarrierEstimate()
+{
+    if(_gr_demod_base)
+        _gr_demod_base->start_carrier_estimate();
+}
+
+int gr_modem::getCarrierOffset(float &offset_hz)
+{
+    if(_gr_demod_base)
+        return _gr_demod_base->get_carrier_offset(offset_hz);
+    return 0;
+}
+
 void gr_modem::tune(long center_freq)
 {
     if(_gr_demod_base)
@@ -281,6 +332,72 @@ void gr_modem::enableGUIFFT(bool value)
 void gr_modem::setRepeater(bool value)
 {
     _repeater = value;
+    _repeater_queue->clear();
+    _repeater_queue->resetLatency();
+}
+
+/**
+ * Same mode repeat: the received bytes are queued for transmission behind a
+ * regenerated sync word, without going through the vocoder or the
+ * text and voice framing paths. Returns false if the frame has to be
+ * rebuilt for a different TX mode.
+ */
+bool gr_modem::repeatFrame(const ByteFrame &received_data, int frame_type)
+{
+    if(_modem_type_rx != _modem_type_tx)
+        return false;
+    std::vector<unsigned char> *data = new std::vector<unsigned char>;
+    data->reserve(received_data.size() + 3);
+    const unsigned char *payload = received_data.constData();
+    int size = received_data.size();
+    switch(frame_type)
+    {
+    case FrameTypeVoice:
+        if(_modem_type_tx == gr_modem_types::ModemTypeBPSK1000)
+        {
+            data->push_back(0xB5);
+            size = _rx_frame_length;
+        }
+        else
+        {
+            // the reserved byte after the sync word is part of the payload
+            data->push_back(0xED);
+            data->push_back(0x89);
+        }
+        break;
+    case FrameTypeText:
+        data->push_back(0x89);
+        data->push_back(0xED);
+        data->push_back(0xAA);
+        break;
+    case FrameTypeCallsign:
+        data->push_back(0x8C);
+        data->push_back(0xC8);
+        data->push_back(0xDD);
+        break;
+    default:
+        delete data;
+        return false;
+    }
+    data->insert(data->end(), payload, payload + size);
+    _repeater_queue->push(data);
+    flushRepeater();
+    return true;
+}
+
+/// Hands every frame whose hold time has passed to the modulator
+void gr_modem::flushRepeater()
+{
+    if(!_gr_mod_base)
+        return;
+    std::vector<unsigned char> *data;
+    while((data = _repeater_queue->front()) != 0)
+    {
+        // the modulator takes ownership on success, retry on the next pass if busy
+        if(_gr_mod_base->setData(data) != 0)
+            break;
+        _repeater_queue->pop();
+    }
 }
 
 void gr_modem::sendCallsign(QString callsign)
@@ -325,6 +442,7 @@ void gr_modem::endTransmission(QString callsign)
 {
     _frame_counter = 0;
     _transmitting = false;
+    flushVoiceFrames();
     sendCallsign(callsign);
     std::vector<unsigned char> *tx_end = new std::vector<unsigned char>;
     tx_end->push_back(0x4C);
@@ -339,13 +457,46 @@ void gr_modem::endTransmission(QString callsign)
     transmit(frames);
 }
 
-void gr_modem::processAudioData(unsigned char *data, int size)
+void gr_modem::processAudioData(ByteFrame data)
 {
-    std::vector<unsigned char> *one_frame = frame(data, size, FrameTypeVoice);
+    int voice_frames = voiceFrames(_modem_type_tx);
+    if(voice_frames > 1)
+    {
+        _tx_voice_frames.insert(_tx_voice_frames.end(), data.constData(), data.constData() + data.size());
+        if((int)_tx_voice_frames.size() < voice_frames * data.size())
+            return;
+        std::vector<unsigned char> *one_frame = frame(&(_tx_voice_frames[0]),
+                _tx_voice_frames.size(), FrameTypeVoice);
+        _tx_voice_frames.clear();
+        QVector<std::vector<unsigned char>*> frames;
+        frames.append(one_frame);
+        transmit(frames);
+        return;
+    }
+    std::vector<unsigned char> *one_frame = frame(data.constData(), data.size(), FrameTypeVoice);
+    QVector<std::vector<unsigned char>*> frames;
+    frames.append(one_frame);
+    transmit(frames);
+}
+
+void gr_modem::flushVoiceFrames()
+{
+    if(_tx_voice_frames.empty())
+        return;
+    // complete the last superframe by repeating the last vocoder frame
+    int superframe_size = voiceFrames(_modem_type_tx) * _tx_frame_length;
+    std::vector<unsigned char> last_frame(_tx_voice_frames.end() - _tx_frame_length,
+                                          _tx_voice_frames.end());
+    while((int)_tx_voice_frames.size() < superframe_size)
+    {
+        _tx_voice_frames.insert(_tx_voice_frames.end(), last_frame.begin(), last_frame.end());
+    }
+    std::vector<unsigned char> *one_frame = frame(&(_tx_voice_frames[0]),
+            superframe_size, FrameTypeVoice);
+    _tx_voice_frames.clear();
     QVector<std::vector<unsigned char>*> frames;
     frames.append(one_frame);
     transmit(frames);
-    delete[] data;
 }
 
 void gr_modem::textData(QString text)
@@ -372,7 +523,7 @@ void gr_modem::textData(QString text)
     transmit(frames);
 }
 
-void gr_modem::processPCMAudio(std::vector<float> *audio_data)
+void gr_modem::processPCMAudio(FloatFrame audio_data)
 {
 
     if((_modem_type_tx == gr_modem_types::ModemTypeNBFM2500)
@@ -384,21 +535,20 @@ void gr_modem::processPCMAudio(std::vector<float> *audio_data)
         while(ret)
         {
             usleep(1);
-            ret = _gr_mod_base->setAudio(audio_data);
+            ret = _gr_mod_base->setAudio(audio_data.constData(), audio_data.size());
         }
     }
 }
 
-void gr_modem::processVideoData(unsigned char *data, int size)
+void gr_modem::processVideoData(ByteFrame data)
 {
-    std::vector<unsigned char> *one_frame = frame(data, size, FrameTypeVideo);
+    std::vector<unsigned char> *one_frame = frame(data.constData(), data.size(), FrameTypeVideo);
     QVector<std::vector<unsigned char>*> frames;
     frames.append(one_frame);
     transmit(frames);
-    delete[] data;
 }
 
-void gr_modem::processNetData(unsigned char *data, int size)
+void gr_modem::processNetData(ByteFrame data)
 {
     QVector<std::vector<unsigned char>*> frames;
     for(int i = 0;i<48;i++)
@@ -416,10 +566,9 @@ void gr_modem::processNetData(unsigned char *data, int size)
         tx_start->push_back(0x8C);
         frames.append(tx_start);
     }
-    std::vector<unsigned char> *one_frame = frame(data, size, FrameTypeData);
+    std::vector<unsigned char> *one_frame = frame(data.constData(), data.size(), FrameTypeData);
     frames.append(one_frame);
     transmit(frames);
-    delete[] data;
 }
 
 void gr_modem::transmit(QVector<std::vector<unsigned char>*> frames)
@@ -440,7 +589,7 @@ void gr_modem::transmit(QVector<std::vector<unsigned char>*> frames)
 
 }
 
-std::vector<unsigned char>* gr_modem::frame(unsigned char *encoded_audio, int data_size, int frame_type)
+std::vector<unsigned char>* gr_modem::frame(const unsigned char *encoded_audio, int data_size, int frame_type)
 {
     std::vector<unsigned char> *data = new std::vector<unsigned char>;
     if(frame_type == FrameTypeVoice)
@@ -473,10 +622,7 @@ std::vector<unsigned char>* gr_modem::frame(unsigned char *encoded_audio, int da
 
     if(_modem_type_tx != gr_modem_types::ModemTypeBPSK1000)
         data->push_back(0xAA); // frame start
-    for(int i=0;i< data_size;i++)
-    {
-        data->push_back(encoded_audio[i]);
-    }
+    data->insert(data->end(), encoded_audio, encoded_audio + data_size);
 
     return data;
 
@@ -511,28 +657,26 @@ static void unpackBytes(unsigned char *bitbuf, const unsigned char *bytebuf, int
 
 void gr_modem::demodulateAnalog()
 {
-    std::vector<float> *audio_data;
-    if((_modem_type_rx == gr_modem_types::ModemTypeNBFM2500)
-            || (_modem_type_rx == gr_modem_types::ModemTypeNBFM5000)
-            || (_modem_type_rx == gr_modem_types::ModemTypeSSB2500)
-            || (_modem_type_rx == gr_modem_types::ModemTypeAM5000)
-            || (_modem_type_rx == gr_modem_types::ModemTypeWBFM))
-    {
-        audio_data = _gr_demod_base->getAudio();
-    }
-    if(audio_data->size() > 0)
+    if((_modem_type_rx != gr_modem_types::ModemTypeNBFM2500)
+            && (_modem_type_rx != gr_modem_types::ModemTypeNBFM5000)
+            && (_modem_type_rx != gr_modem_types::ModemTypeSSB2500)
+            && (_modem_type_rx != gr_modem_types::ModemTypeAM5000)
+            && (_modem_type_rx != gr_modem_types::ModemTypeWBFM))
+        return;
+    int available = _gr_demod_base->getAudioAvailable();
+    if(available < 320)
+        return;
+    FloatFrame audio_data(available);
+    int size = _gr_demod_base->getAudio(audio_data.data(), available);
+    audio_data.resize(size);
+    if(size > 0)
     {
         if(_repeater)
         {
-            std::vector<float> *repeated_audio = new std::vector<float>(audio_data->begin(),audio_data->end());
-            processPCMAudio(repeated_audio);
+            processPCMAudio(audio_data);
         }
         emit pcmAudio(audio_data);
     }
-    else
-    {
-        delete audio_data;
-    }
 
 }
 
@@ -584,6 +728,8 @@ void gr_modem::demodulate()
         demod_data2->clear();
         delete demod_data2;
     }
+    if(_repeater)
+        flushRepeater();
 
 }
 
@@ -618,7 +764,8 @@ void gr_modem::synchronize(int v_size, std::vector<unsigned char> *data)
             if((_modem_type_rx != gr_modem_types::ModemTypeBPSK1000)
                     && (_current_frame_type == FrameTypeVoice))
             {
-                frame_length++; // reserved data
+                frame_length = frame_length * _rx_voice_frames + 1; // reserved data
+                bit_buf_len = frame_length * 8;
             }
             else
             {
@@ -627,8 +774,8 @@ void gr_modem::synchronize(int v_size, std::vector<unsigned char> *data)
             if(_bit_buf_index >= bit_buf_len)
             {
 
-                unsigned char *frame_data = new unsigned char[frame_length];
-                packBytes(frame_data,_bit_buf,_bit_buf_index);
+                ByteFrame frame_data(frame_length);
+                packBytes(frame_data.data(),_bit_buf,_bit_buf_index);
                 processReceivedData(frame_data, _current_frame_type);
                 _sync_found = false;
                 _shift_reg = 0;
@@ -691,14 +838,13 @@ int gr_modem::findSync(unsigned char bit)
 }
 
 
-void gr_modem::processReceivedData(unsigned char *received_data, int current_frame_type)
+void gr_modem::processReceivedData(ByteFrame received_data, int current_frame_type)
 {
     if (current_frame_type == FrameTypeText)
     {
         emit dataFrameReceived();
         _last_frame_type = FrameTypeText;
-        char *text_data = new char[_rx_frame_length];
-        memcpy(text_data, received_data, _rx_frame_length);
+        const char *text_data = (const char*)received_data.constData();
         quint8 string_length = _rx_frame_length;
 
         for(int ii=_rx_frame_length-1;ii>=0;ii--)
@@ -714,19 +860,17 @@ void gr_modem::processReceivedData(unsigned char *received_data, int current_fra
             }
         }
         QString text = QString::fromLocal8Bit(text_data,string_length);
-        if(_repeater)
+        if(_repeater && !repeatFrame(received_data, FrameTypeText))
         {
             textData(text);
         }
         emit textReceived(text);
-        delete[] text_data;
     }
     else if (current_frame_type == FrameTypeCallsign)
     {
         emit dataFrameReceived();
         _last_frame_type = FrameTypeCallsign;
-        char *text_data = new char[_rx_frame_length];
-        memcpy(text_data, received_data, _rx_frame_length);
+        const char *text_data = (const char*)received_data.constData();
         quint8 string_length = _rx_frame_length;
 
         for(int ii=_rx_frame_length-1;ii>=0;ii--)
@@ -738,53 +882,74 @@ void gr_modem::processReceivedData(unsigned char *received_data, int current_fra
             }
         }
         QString callsign = QString::fromLocal8Bit(text_data,string_length);
-        if(_repeater)
+        if(_repeater && !repeatFrame(received_data, FrameTypeCallsign))
         {
             sendCallsign(callsign);
         }
         emit callsignReceived(callsign);
-        delete[] text_data;
     }
     else if (current_frame_type == FrameTypeVoice )
     {
         emit audioFrameReceived();
         _last_frame_type = FrameTypeVoice;
-        unsigned char *codec2_data = new unsigned char[_rx_frame_length];
-        memset(codec2_data,0,_rx_frame_length);
+        // cross mode repeat needs the vocoder frames reframed one by one
+        bool reframe = _repeater && !repeatFrame(received_data, FrameTypeVoice);
+        ByteFrame codec2_data;
         if(_modem_type_rx == gr_modem_types::ModemTypeBPSK1000)
-            memcpy(codec2_data, received_data, _rx_frame_length);
+        {
+            codec2_data = received_data;
+            codec2_data.resize(_rx_frame_length);
+        }
         else
-            memcpy(codec2_data, received_data+1, _rx_frame_length);
-        if(_repeater)
         {
-            unsigned char *repeated_frame = new unsigned char[_rx_frame_length];
-            memcpy(repeated_frame, codec2_data, _rx_frame_length);
-            processAudioData(repeated_frame, _rx_frame_length);
+            // skip the reserved byte after the sync word
+            for(int i=0;i<_rx_voice_frames - 1;i++)
+            {
+                // all but the last vocoder frame of a superframe
+                ByteFrame voice_frame(received_data.constData() + 1 + i * _rx_frame_length,
+                                      _rx_frame_length);
+                if(reframe)
+                {
+                    processAudioData(voice_frame);
+                }
+                emit digitalAudio(voice_frame);
+            }
+            codec2_data = ByteFrame(received_data.constData() + 1 + (_rx_voice_frames - 1) * _rx_frame_length,
+                                    _rx_frame_length);
+        }
+        if(reframe)
+        {
+            processAudioData(codec2_data);
         }
-        emit digitalAudio(codec2_data,_rx_frame_length);
+        emit digitalAudio(codec2_data);
     }
     else if (current_frame_type == FrameTypeVideo )
     {
         emit dataFrameReceived();
         _last_frame_type = FrameTypeVideo;
-        unsigned char *video_data = new unsigned char[_rx_frame_length];
-        memcpy(video_data, received_data, _rx_frame_length);
-        emit videoData(video_data,_rx_frame_length);
+        received_data.resize(_rx_frame_length);
+        emit videoData(received_data);
     }
     else if (current_frame_type == FrameTypeData )
     {
         emit dataFrameReceived();
         _last_frame_type = FrameTypeData;
-        unsigned char *net_data = new unsigned char[_rx_frame_length];
-        memcpy(net_data, received_data, _rx_frame_length);
-        emit netData(net_data,_rx_frame_length);
+        received_data.resize(_rx_frame_length);
+        emit netData(received_data);
         // poke repeater here
     }
-    delete[] received_data;
 }
 
 void gr_modem::handleStreamEnd()
 {
+    if(_repeater && (_repeater_queue->frameCount() > 0))
+    {
+        qDebug() << "Repeater latency ms min:" << _repeater_queue->minLatency()
+                 << "mean:" << _repeater_queue->meanLatency()
+                 << "max:" << _repeater_queue->maxLatency()
+                 << "frames:" << _repeater_queue->frameCount();
+        _repeater_queue->resetLatency();
+    }
     if(_last_frame_type == FrameTypeText)
     {
         emit textReceived( QString("\n"));
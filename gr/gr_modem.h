@@ -25,8 +25,12 @@
 #include <QtEndian>
 #include <QMutex>
 #include <QCoreApplication>
+#include <QDir>
+#include <QDebug>
 #include <string>
+#include <algorithm>
 #include "ext/utils.h"
+#include "ext/framebuffer.h"
 #include "sslclient.h"
 #include "config_defines.h"
 #include "settings.h"
@@ -34,13 +38,15 @@
 #include "modem_types.h"
 #include "gr/gr_mod_base.h"
 #include "gr/gr_demod_base.h"
+#include "gr/gr_taps_cache.h"
+#include "gr/gr_repeater.h"
 #include "gr_mod_gmsk.h"
 #include "gr_demod_gmsk.h"
 #include "gr_mod_bpsk.h"
 #include "gr_demod_bpsk.h"
 #include <gnuradio/qtgui/number_sink.h>
 #include <gnuradio/qtgui/const_sink_c.h>
-#include <gnuradio/qtgui/sink_c.h>
+#include <gnuradio/qtgui/vector_sink_f.h>
 
 
 #include <stdio.h>
@@ -81,7 +87,7 @@ public:
         FrameTypeCallsign,
         FrameTypeEnd
     };
-    explicit gr_modem(Settings *settings, gr::qtgui::sink_c::sptr fft_gui, gr::qtgui::const_sink_c::sptr const_gui,
+    explicit gr_modem(Settings *settings, gr::qtgui::vector_sink_f::sptr fft_gui, gr::qtgui::const_sink_c::sptr const_gui,
                       gr::qtgui::number_sink::sptr rssi_gui, QObject *parent = 0);
     ~gr_modem();
     long _frequency_found;
@@ -90,10 +96,10 @@ public:
 
     void sendCallsign(QString callsign);
 signals:
-    void pcmAudio(std::vector<float>* pcm);
-    void digitalAudio(unsigned char *c2data, int size);
-    void videoData(unsigned char *video_data, int size);
-    void netData(unsigned char *net_data, int size);
+    void pcmAudio(FloatFrame pcm);
+    void digitalAudio(ByteFrame c2data);
+    void videoData(ByteFrame video_data);
+    void netData(ByteFrame net_data);
     void demodulated_audio(short *pcm, short size);
     void textReceived(QString text);
     void callsignReceived(QString text);
@@ -103,10 +109,10 @@ signals:
     void receiveEnd();
     void endAudioTransmission();
 public slots:
-    void processPCMAudio(std::vector<float> *audio_data);
-    void processAudioData(unsigned char *data, int size);
-    void processVideoData(unsigned char *data, int size);
-    void processNetData(unsigned char *data, int size);
+    void processPCMAudio(FloatFrame audio_data);
+    void processAudioData(ByteFrame data);
+    void processVideoData(ByteFrame data);
+    void processNetData(ByteFrame data);
     void demodulate();
     void startTransmission(QString callsign);
     void endTransmission(QString callsign);
@@ -131,19 +137,36 @@ public slots:
     void enableGUIConst(bool value);
     void enableGUIFFT(bool value);
     double getFreqGUI();
+    float getRSSI();
+    void enableSpectrumAnalysis(bool value);
+    bool getSpectrum(std::vector<float> &frame);
+    quint64 getSpectrumFrames();
+    void startCarrierEstimate();
+    int getCarrierOffset(float &offset_hz);
     void setRepeater(bool value);
+    void setTxGate(bool open);
+    bool txIdle();
+    bool txGateOpen();
+    bool txBurstMode();
+    int codec2Mode(int modem_type);
+    int voiceFrames(int modem_type);
 
 private:
 
     Settings *_settings;
     quint64 _sequence_number;
     bool _transmitting;
-    std::vector<unsigned char>* frame(unsigned char *encoded_audio, int data_size, int frame_type=FrameTypeVoice);
-    void processReceivedData(unsigned char* received_data, int current_frame_type);
+    std::vector<unsigned char>* frame(const unsigned char *encoded_audio, int data_size, int frame_type=FrameTypeVoice);
+    void processReceivedData(ByteFrame received_data, int current_frame_type);
+    void flushVoiceFrames();
     void handleStreamEnd();
+    bool repeatFrame(const ByteFrame &received_data, int frame_type);
+    void flushRepeater();
     int findSync(unsigned char bit);
     void transmit(QVector<std::vector<unsigned char>*> frames);
     void synchronize(int v_size, std::vector<unsigned char> *data);
+    void loadFilterTaps();
+    void saveFilterTaps();
 
     gr_mod_base *_gr_mod_base;
     gr_demod_base *_gr_demod_base;
@@ -153,10 +176,13 @@ private:
     gr_demod_bpsk *_gr_demod_bpsk;
 
     bool _repeater;
+    gr_repeater *_repeater_queue;
     int _modem_type_rx;
     int _modem_type_tx;
     int _tx_frame_length;
     int _rx_frame_length;
+    int _rx_voice_frames;
+    std::vector<unsigned char> _tx_voice_frames;
     quint64 _frame_counter;
     quint8 _last_frame_type;
     bool _sync_found;
@@ -164,11 +190,12 @@ private:
     long _bit_buf_index;
     unsigned char *_bit_buf;
     int _bit_buf_len;
+    int _bit_buf_size;
     unsigned long long _shift_reg;
 
     gr::qtgui::const_sink_c::sptr _const_gui;
     gr::qtgui::number_sink::sptr _rssi_gui;
-    gr::qtgui::sink_c::sptr _fft_gui;
+    gr::qtgui::vector_sink_f::sptr _fft_gui;
 
 
 };
@@ -0,0 +1,111 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "gr_repeater.h"
+
+gr_repeater::gr_repeater(int hold_ms)
+{
+    _clock.start();
+    setHoldTime(hold_ms);
+    resetLatency();
+}
+
+gr_repeater::~gr_repeater()
+{
+    clear();
+}
+
+void gr_repeater::setHoldTime(int msec)
+{
+    _hold_ns = (qint64)msec * 1000000LL;
+}
+
+/// Takes ownership of the frame
+void gr_repeater::push(std::vector<unsigned char> *frame)
+{
+    held_frame held;
+    held.data = frame;
+    held.received_ns = _clock.nsecsElapsed();
+    _frames.push_back(held);
+}
+
+/// Oldest frame once its hold time has passed, 0 otherwise
+std::vector<unsigned char> *gr_repeater::front()
+{
+    if(_frames.empty())
+        return 0;
+    if(_clock.nsecsElapsed() - _frames.front().received_ns < _hold_ns)
+        return 0;
+    return _frames.front().data;
+}
+
+/// Drops the front frame after the modulator took ownership of it
+void gr_repeater::pop()
+{
+    if(_frames.empty())
+        return;
+    qint64 latency = _clock.nsecsElapsed() - _frames.front().received_ns;
+    _frames.pop_front();
+    if((_frame_count == 0) || (latency < _latency_min_ns))
+        _latency_min_ns = latency;
+    if(latency > _latency_max_ns)
+        _latency_max_ns = latency;
+    _latency_sum_ns += latency;
+    _frame_count++;
+}
+
+void gr_repeater::clear()
+{
+    for(unsigned int i=0;i<_frames.size();i++)
+        delete _frames[i].data;
+    _frames.clear();
+}
+
+int gr_repeater::size()
+{
+    return (int)_frames.size();
+}
+
+void gr_repeater::resetLatency()
+{
+    _frame_count = 0;
+    _latency_min_ns = 0;
+    _latency_max_ns = 0;
+    _latency_sum_ns = 0;
+}
+
+int gr_repeater::frameCount()
+{
+    return _frame_count;
+}
+
+/// Milliseconds
+float gr_repeater::minLatency()
+{
+    return (float)_latency_min_ns / 1000000.0f;
+}
+
+float gr_repeater::maxLatency()
+{
+    return (float)_latency_max_ns / 1000000.0f;
+}
+
+float gr_repeater::meanLatency()
+{
+    if(_frame_count == 0)
+        return 0;
+    return (float)(_latency_sum_ns / _frame_count) / 1000000.0f;
+}
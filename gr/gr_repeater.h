@@ -0,0 +1,68 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef GR_REPEATER_H
+#define GR_REPEATER_H
+
+#include <QElapsedTimer>
+#include <deque>
+#include <vector>
+
+/**
+ * @brief Frame queue between the deframer and the modulator in repeater mode.
+ *
+ * Received frames arrive here already framed for transmission. Each one is
+ * held for a fixed time after it was received, so the bursty output of the
+ * demodulator reaches the modulator at a constant offset, and is then taken
+ * by the modem without blocking the receive loop. The time every frame spent
+ * between reception and hand-off to the modulator is recorded.
+ */
+class gr_repeater
+{
+public:
+    explicit gr_repeater(int hold_ms=40);
+    ~gr_repeater();
+
+    void setHoldTime(int msec);
+    void push(std::vector<unsigned char> *frame);
+    std::vector<unsigned char> *front();
+    void pop();
+    void clear();
+    int size();
+
+    void resetLatency();
+    int frameCount();
+    float minLatency();
+    float maxLatency();
+    float meanLatency();
+
+private:
+    struct held_frame
+    {
+        std::vector<unsigned char> *data;
+        qint64 received_ns;
+    };
+
+    std::deque<held_frame> _frames;
+    QElapsedTimer _clock;
+    qint64 _hold_ns;
+    int _frame_count;
+    qint64 _latency_min_ns;
+    qint64 _latency_max_ns;
+    qint64 _latency_sum_ns;
+};
+
+#endif // GR_REPEATER_H
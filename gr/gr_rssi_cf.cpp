@@ -0,0 +1,126 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#include "gr_rssi_cf.h"
+
+gr_rssi_cf_sptr make_gr_rssi_cf(int samp_rate, int update_rate, float level_offset, float alpha)
+{
+    return gnuradio::get_initial_sptr(new gr_rssi_cf(samp_rate, update_rate, level_offset, alpha));
+}
+
+gr_rssi_cf::gr_rssi_cf(int samp_rate, int update_rate, float level_offset, float alpha) :
+    gr::block("gr_rssi_cf",
+              gr::io_signature::make (1, 1, sizeof (gr_complex)),
+              gr::io_signature::make (1, 1, sizeof (float)))
+{
+    _samp_rate = samp_rate;
+    _update_rate = std::max(1, update_rate);
+    _level_offset = level_offset;
+    _alpha = alpha;
+    _avg_power = 0.0;
+    _rssi = -200.0;
+    _primed = false;
+    reset_window();
+}
+
+/// Called with the mutex held
+void gr_rssi_cf::reset_window()
+{
+    _window = std::max(1, _samp_rate / _update_rate);
+    _window_count = 0;
+    _window_sum = 0.0;
+}
+
+void gr_rssi_cf::set_samp_rate(int samp_rate)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    _samp_rate = samp_rate;
+    reset_window();
+    _primed = false;
+}
+
+void gr_rssi_cf::set_update_rate(int update_rate)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    _update_rate = std::max(1, update_rate);
+    reset_window();
+}
+
+void gr_rssi_cf::set_level_offset(float level_offset)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    _level_offset = level_offset;
+}
+
+float gr_rssi_cf::get_rssi()
+{
+    gr::thread::scoped_lock guard(_mutex);
+    return _rssi;
+}
+
+void gr_rssi_cf::forecast(int noutput_items, gr_vector_int &ninput_items_required)
+{
+    (void)noutput_items;
+    // a window can be longer than the input buffer, it is summed across calls
+    ninput_items_required[0] = 1;
+}
+
+int gr_rssi_cf::general_work(int noutput_items,
+                             gr_vector_int &ninput_items,
+                             gr_vector_const_void_star &input_items,
+                             gr_vector_void_star &output_items)
+{
+    const gr_complex *in = (const gr_complex*)(input_items[0]);
+    float *out = (float*)(output_items[0]);
+    int available = ninput_items[0];
+
+    gr::thread::scoped_lock guard(_mutex);
+    int consumed = 0;
+    int produced = 0;
+    while((consumed < available) && (produced < noutput_items))
+    {
+        int n = std::min(available - consumed, _window - _window_count);
+        const gr_complex *block = in + consumed;
+        float sum = 0.0;
+        for(int j=0;j < n;j++)
+        {
+            sum += block[j].real() * block[j].real() + block[j].imag() * block[j].imag();
+        }
+        _window_sum += sum;
+        _window_count += n;
+        consumed += n;
+        if(_window_count < _window)
+            break;
+        float power = _window_sum / (float)_window;
+        _window_count = 0;
+        _window_sum = 0.0;
+        if(!_primed)
+        {
+            _avg_power = power;
+            _primed = true;
+        }
+        else
+        {
+            _avg_power = _alpha * power + (1.0 - _alpha) * _avg_power;
+        }
+        out[produced++] = 10.0 * log10f(_avg_power + 1e-20) + _level_offset;
+    }
+    if(produced > 0)
+        _rssi = out[produced - 1];
+    consume(0, consumed);
+    return produced;
+}
@@ -0,0 +1,71 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#ifndef GR_RSSI_CF_H
+#define GR_RSSI_CF_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <math.h>
+#include <stdint.h>
+#include <algorithm>
+
+class gr_rssi_cf;
+typedef boost::shared_ptr<gr_rssi_cf> gr_rssi_cf_sptr;
+
+gr_rssi_cf_sptr make_gr_rssi_cf(int samp_rate=20000, int update_rate=10, float level_offset=-66.0,
+                                float alpha=0.5);
+
+/**
+ * @brief Integrates signal power over one update window and outputs
+ * one smoothed reading in dB per window, so the RSSI display and
+ * any carrier sense logic only see update_rate items per second.
+ * The window is counted here rather than as a decimation, so the
+ * sample rate can change while the flowgraph runs.
+ */
+class gr_rssi_cf : public gr::block
+{
+public:
+    gr_rssi_cf(int samp_rate, int update_rate, float level_offset, float alpha);
+    void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+    int general_work(int noutput_items,
+                     gr_vector_int &ninput_items,
+                     gr_vector_const_void_star &input_items,
+                     gr_vector_void_star &output_items);
+
+    void set_samp_rate(int samp_rate);
+    void set_update_rate(int update_rate);
+    void set_level_offset(float level_offset);
+    float get_rssi();
+
+private:
+    void reset_window();
+
+    int _samp_rate;
+    int _update_rate;
+    float _level_offset;
+    float _alpha;
+    float _avg_power;
+    float _rssi;
+    bool _primed;
+    int _window;
+    int _window_count;
+    float _window_sum;
+    gr::thread::mutex _mutex;
+};
+
+#endif // GR_RSSI_CF_H
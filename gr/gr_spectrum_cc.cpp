@@ -0,0 +1,271 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#include "gr_spectrum_cc.h"
+
+gr_spectrum_cc_sptr make_gr_spectrum_cc(int fft_size, int samp_rate, int frame_rate, int averaging)
+{
+    return gnuradio::get_initial_sptr(new gr_spectrum_cc(fft_size, samp_rate, frame_rate, averaging));
+}
+
+gr_spectrum_cc::gr_spectrum_cc(int fft_size, int samp_rate, int frame_rate, int averaging) :
+    gr::block("gr_spectrum_cc",
+              gr::io_signature::make (1, 1, sizeof (gr_complex)),
+              gr::io_signature::make (0, 1, sizeof (float) * fft_size))
+{
+    _fft_size = fft_size;
+    _samp_rate = samp_rate;
+    _frame_rate = std::max(1, frame_rate);
+    _averaging = std::max(1, averaging);
+    _forward = false;
+    _analysis = true;
+    _discard = false;
+    _fill = 0;
+    _skip = 0;
+    _frame_count = 0;
+    // the plan is created once and reused for every frame
+    _fft = new gr::fft::fft_complex(_fft_size, true, 1);
+    _window = gr::fft::window::blackmanharris(_fft_size);
+    float window_power = 0;
+    for(int i=0;i<_fft_size;i++)
+        window_power += _window[i] * _window[i];
+    _scale = 1.0 / (window_power * (float)_fft_size);
+    _avg_power.resize(_fft_size, 0);
+    _frame.resize(_fft_size, -200.0);
+    message_port_register_out(pmt::mp("spectrum"));
+    update_skip();
+}
+
+gr_spectrum_cc::~gr_spectrum_cc()
+{
+    delete _fft;
+}
+
+void gr_spectrum_cc::update_skip()
+{
+    _skip_len = std::max(0, _samp_rate / _frame_rate - _fft_size);
+}
+
+void gr_spectrum_cc::set_samp_rate(int samp_rate)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    _samp_rate = samp_rate;
+    update_skip();
+}
+
+void gr_spectrum_cc::set_frame_rate(int frame_rate)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    _frame_rate = std::max(1, frame_rate);
+    update_skip();
+}
+
+void gr_spectrum_cc::set_averaging(int averaging)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    _averaging = std::max(1, averaging);
+}
+
+void gr_spectrum_cc::set_forward(bool value)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    // a chunk captured while no frames were computed is not in the FFT buffer
+    if(value && !_forward && !_analysis)
+        _fill = 0;
+    _forward = value;
+}
+
+void gr_spectrum_cc::set_analysis(bool value)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    if(value && !_analysis)
+    {
+        _frame_count = 0;
+        if(!_forward)
+            _fill = 0;
+    }
+    _analysis = value;
+}
+
+int gr_spectrum_cc::fft_size()
+{
+    return _fft_size;
+}
+
+int gr_spectrum_cc::samp_rate()
+{
+    gr::thread::scoped_lock guard(_mutex);
+    return _samp_rate;
+}
+
+bool gr_spectrum_cc::get_spectrum(std::vector<float> &frame)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    if(_frame_count < 1)
+        return false;
+    frame = _frame;
+    return true;
+}
+
+uint64_t gr_spectrum_cc::get_frame_count()
+{
+    gr::thread::scoped_lock guard(_mutex);
+    return _frame_count;
+}
+
+void gr_spectrum_cc::reset()
+{
+    gr::thread::scoped_lock guard(_mutex);
+    _fill = 0;
+    _skip = 0;
+    _frame_count = 0;
+    // samples already queued upstream still belong to the old frequency,
+    // the next frame is dropped and the average restarts from the one after
+    _discard = true;
+}
+
+/**
+ * Band edge estimate: the signal is taken as the contiguous run of bins
+ * around the strongest bin which stay within snr_db/2 of it. The midpoint
+ * of the two edges is used rather than the peak bin, which is unreliable
+ * for flat topped PSK spectra and for FSK tones of unequal weight.
+ * The peak is searched within +-search_hz, the noise floor is the median
+ * of the bins between search_hz and noise_hz on both sides, so that a
+ * signal filling the search range does not raise it.
+ */
+bool gr_spectrum_cc::estimate_carrier(float snr_db, float search_hz, float noise_hz, float &offset_hz)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    if(_frame_count < 1)
+        return false;
+    int half = _fft_size / 2;
+    float bin_hz = (float)_samp_rate / (float)_fft_size;
+    int search = std::min(half - 1, (int)(search_hz / bin_hz));
+    int outer = std::min(half - 1, (int)(noise_hz / bin_hz));
+    if(outer <= search)
+        return false;
+    std::vector<float> noise;
+    noise.reserve(2 * (outer - search));
+    for(int i=search+1;i<=outer;i++)
+    {
+        noise.push_back(_frame[half - i]);
+        noise.push_back(_frame[half + i]);
+    }
+    std::nth_element(noise.begin(), noise.begin() + noise.size() / 2, noise.end());
+    float noise_floor = noise[noise.size() / 2];
+    int low_limit = half - search;
+    int high_limit = half + search;
+    int peak = std::max_element(_frame.begin() + low_limit, _frame.begin() + high_limit + 1)
+            - _frame.begin();
+    if(_frame[peak] - noise_floor < snr_db)
+        return false;
+    float edge_level = _frame[peak] - snr_db / 2;
+    int low = peak;
+    while((low > low_limit) && (_frame[low - 1] >= edge_level))
+        low--;
+    int high = peak;
+    while((high < high_limit) && (_frame[high + 1] >= edge_level))
+        high++;
+    float center_bin = (float)(low + high) / 2.0 - (float)half;
+    offset_hz = center_bin * bin_hz;
+    return true;
+}
+
+void gr_spectrum_cc::process_frame()
+{
+    if(_discard)
+    {
+        _discard = false;
+        return;
+    }
+    gr_complex *buf = _fft->get_inbuf();
+    for(int i=0;i<_fft_size;i++)
+        buf[i] *= _window[i];
+    _fft->execute();
+    gr_complex *out = _fft->get_outbuf();
+
+    float alpha = 1.0 / (float)_averaging;
+    int half = _fft_size / 2;
+    for(int i=0;i<_fft_size;i++)
+    {
+        float power = (out[i].real() * out[i].real() + out[i].imag() * out[i].imag()) * _scale;
+        if(_frame_count < 1)
+            _avg_power[i] = power;
+        else
+            _avg_power[i] = alpha * power + (1.0 - alpha) * _avg_power[i];
+        // swap halves so the frame starts at -samp_rate/2
+        _frame[(i + half) % _fft_size] = 10.0 * log10f(_avg_power[i] + 1e-20);
+    }
+    _frame_count++;
+    message_port_pub(pmt::mp("spectrum"), pmt::init_f32vector(_fft_size, &_frame[0]));
+}
+
+void gr_spectrum_cc::forecast(int noutput_items, gr_vector_int &ninput_items_required)
+{
+    (void)noutput_items;
+    // frames are assembled across calls, any input makes progress
+    ninput_items_required[0] = 1;
+}
+
+int gr_spectrum_cc::general_work(int noutput_items,
+                                 gr_vector_int &ninput_items,
+                                 gr_vector_const_void_star &input_items,
+                                 gr_vector_void_star &output_items)
+{
+    const gr_complex *in = (const gr_complex*)(input_items[0]);
+    float *out = output_items.size() > 0 ? (float*)(output_items[0]) : 0;
+
+    gr::thread::scoped_lock guard(_mutex);
+    int ninput = ninput_items[0];
+    int consumed = 0;
+    int produced = 0;
+    bool forward = _forward && out;
+    bool compute = _analysis || forward;
+    while(consumed < ninput)
+    {
+        if(_skip > 0)
+        {
+            int n = std::min(_skip, ninput - consumed);
+            _skip -= n;
+            consumed += n;
+            continue;
+        }
+        // the frame would have nowhere to go, leave the input for later
+        if(forward && (produced >= noutput_items))
+            break;
+        int n = std::min(_fft_size - _fill, ninput - consumed);
+        if(compute)
+            memcpy(_fft->get_inbuf() + _fill, in + consumed, n * sizeof(gr_complex));
+        _fill += n;
+        consumed += n;
+        if(_fill >= _fft_size)
+        {
+            uint64_t frames = _frame_count;
+            if(compute)
+                process_frame();
+            if(forward && (_frame_count > frames))
+            {
+                memcpy(out + produced * _fft_size, &_frame[0], _fft_size * sizeof(float));
+                produced++;
+            }
+            _fill = 0;
+            _skip = _skip_len;
+        }
+    }
+    consume_each(consumed);
+    return produced;
+}
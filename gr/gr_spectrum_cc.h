@@ -0,0 +1,98 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#ifndef GR_SPECTRUM_CC_H
+#define GR_SPECTRUM_CC_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/fft/fft.h>
+#include <gnuradio/fft/window.h>
+#include <pmt/pmt.h>
+#include <vector>
+#include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <algorithm>
+
+class gr_spectrum_cc;
+typedef boost::shared_ptr<gr_spectrum_cc> gr_spectrum_cc_sptr;
+
+gr_spectrum_cc_sptr make_gr_spectrum_cc(int fft_size=8192, int samp_rate=1000000,
+                                        int frame_rate=10, int averaging=4);
+
+/**
+ * @brief Computes averaged, windowed power spectrum frames at a fixed
+ * frame rate regardless of the input sample rate.
+ *
+ * Only fft_size samples are taken out of every samp_rate/frame_rate
+ * input samples, the rest are dropped. Frames are DC centered and in dB.
+ * While forwarding, each frame is sent on the output as one vector of
+ * fft_size floats for a vector sink to display, so the GUI shows the
+ * averaged frames and does no FFT of its own. Frames are computed only
+ * while forwarding or while analysis is enabled for a consumer such as
+ * the scanner. Each frame is also published on the "spectrum" message
+ * port as an f32vector, for export to remote clients.
+ */
+class gr_spectrum_cc : public gr::block
+{
+public:
+    gr_spectrum_cc(int fft_size, int samp_rate, int frame_rate, int averaging);
+    ~gr_spectrum_cc();
+
+    void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+    int general_work(int noutput_items,
+                     gr_vector_int &ninput_items,
+                     gr_vector_const_void_star &input_items,
+                     gr_vector_void_star &output_items);
+
+    void set_samp_rate(int samp_rate);
+    void set_frame_rate(int frame_rate);
+    void set_averaging(int averaging);
+    void set_forward(bool value);
+    void set_analysis(bool value);
+    int fft_size();
+    int samp_rate();
+    bool get_spectrum(std::vector<float> &frame);
+    uint64_t get_frame_count();
+    void reset();
+    bool estimate_carrier(float snr_db, float search_hz, float noise_hz, float &offset_hz);
+
+private:
+    void process_frame();
+    void update_skip();
+
+    gr::fft::fft_complex *_fft;
+    std::vector<float> _window;
+    std::vector<float> _avg_power;
+    std::vector<float> _frame;
+    int _fft_size;
+    int _samp_rate;
+    int _frame_rate;
+    int _averaging;
+    float _scale;
+    bool _forward;
+    bool _analysis;
+    bool _discard;
+    int _fill;
+    int _skip;
+    int _skip_len;
+    uint64_t _frame_count;
+    gr::thread::mutex _mutex;
+};
+
+#endif // GR_SPECTRUM_CC_H
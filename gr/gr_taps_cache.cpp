@@ -0,0 +1,276 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#include "gr_taps_cache.h"
+
+static const char TAPS_CACHE_MAGIC[4] = {'Q', 'R', 'L', 'T'};
+static const uint32_t TAPS_CACHE_VERSION = 1;
+
+std::map<std::string, std::vector<float> > gr_taps_cache::_real_taps;
+std::map<std::string, std::vector<gr_complex> > gr_taps_cache::_complex_taps;
+gr::thread::mutex gr_taps_cache::_mutex;
+bool gr_taps_cache::_dirty = false;
+
+std::string gr_taps_cache::make_key(const char *type, int count, const double *params)
+{
+    std::string key(type);
+    char buf[32];
+    for(int i=0;i<count;i++)
+    {
+        snprintf(buf, sizeof(buf), ":%.10g", params[i]);
+        key.append(buf);
+    }
+    return key;
+}
+
+bool gr_taps_cache::lookup(const std::string &key, std::vector<float> &taps)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    std::map<std::string, std::vector<float> >::const_iterator it = _real_taps.find(key);
+    if(it == _real_taps.end())
+        return false;
+    taps = it->second;
+    return true;
+}
+
+bool gr_taps_cache::lookup(const std::string &key, std::vector<gr_complex> &taps)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    std::map<std::string, std::vector<gr_complex> >::const_iterator it = _complex_taps.find(key);
+    if(it == _complex_taps.end())
+        return false;
+    taps = it->second;
+    return true;
+}
+
+void gr_taps_cache::store(const std::string &key, const std::vector<float> &taps)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    _real_taps[key] = taps;
+    _dirty = true;
+}
+
+void gr_taps_cache::store(const std::string &key, const std::vector<gr_complex> &taps)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    _complex_taps[key] = taps;
+    _dirty = true;
+}
+
+std::vector<float> gr_taps_cache::low_pass(double gain, double sampling_freq, double cutoff_freq,
+                                           double transition_width,
+                                           gr::filter::firdes::win_type window, double beta)
+{
+    double params[] = {gain, sampling_freq, cutoff_freq, transition_width, (double)window, beta};
+    std::string key = make_key("lp", 6, params);
+    std::vector<float> taps;
+    if(lookup(key, taps))
+        return taps;
+    taps = gr::filter::firdes::low_pass(gain, sampling_freq, cutoff_freq, transition_width, window, beta);
+    store(key, taps);
+    return taps;
+}
+
+std::vector<float> gr_taps_cache::high_pass(double gain, double sampling_freq, double cutoff_freq,
+                                            double transition_width,
+                                            gr::filter::firdes::win_type window, double beta)
+{
+    double params[] = {gain, sampling_freq, cutoff_freq, transition_width, (double)window, beta};
+    std::string key = make_key("hp", 6, params);
+    std::vector<float> taps;
+    if(lookup(key, taps))
+        return taps;
+    taps = gr::filter::firdes::high_pass(gain, sampling_freq, cutoff_freq, transition_width, window, beta);
+    store(key, taps);
+    return taps;
+}
+
+std::vector<float> gr_taps_cache::band_pass(double gain, double sampling_freq, double low_cutoff_freq,
+                                            double high_cutoff_freq, double transition_width,
+                                            gr::filter::firdes::win_type window, double beta)
+{
+    double params[] = {gain, sampling_freq, low_cutoff_freq, high_cutoff_freq, transition_width,
+                       (double)window, beta};
+    std::string key = make_key("bp", 7, params);
+    std::vector<float> taps;
+    if(lookup(key, taps))
+        return taps;
+    taps = gr::filter::firdes::band_pass(gain, sampling_freq, low_cutoff_freq, high_cutoff_freq,
+                                         transition_width, window, beta);
+    store(key, taps);
+    return taps;
+}
+
+std::vector<gr_complex> gr_taps_cache::complex_band_pass(double gain, double sampling_freq,
+                                            double low_cutoff_freq, double high_cutoff_freq,
+                                            double transition_width,
+                                            gr::filter::firdes::win_type window, double beta)
+{
+    double params[] = {gain, sampling_freq, low_cutoff_freq, high_cutoff_freq, transition_width,
+                       (double)window, beta};
+    std::string key = make_key("cbp", 7, params);
+    std::vector<gr_complex> taps;
+    if(lookup(key, taps))
+        return taps;
+    taps = gr::filter::firdes::complex_band_pass(gain, sampling_freq, low_cutoff_freq, high_cutoff_freq,
+                                                 transition_width, window, beta);
+    store(key, taps);
+    return taps;
+}
+
+std::vector<gr_complex> gr_taps_cache::complex_band_pass_2(double gain, double sampling_freq,
+                                            double low_cutoff_freq, double high_cutoff_freq,
+                                            double transition_width, double attenuation_dB,
+                                            gr::filter::firdes::win_type window, double beta)
+{
+    double params[] = {gain, sampling_freq, low_cutoff_freq, high_cutoff_freq, transition_width,
+                       attenuation_dB, (double)window, beta};
+    std::string key = make_key("cbp2", 8, params);
+    std::vector<gr_complex> taps;
+    if(lookup(key, taps))
+        return taps;
+    taps = gr::filter::firdes::complex_band_pass_2(gain, sampling_freq, low_cutoff_freq, high_cutoff_freq,
+                                                   transition_width, attenuation_dB, window, beta);
+    store(key, taps);
+    return taps;
+}
+
+std::vector<float> gr_taps_cache::root_raised_cosine(double gain, double sampling_freq, double symbol_rate,
+                                                     double alpha, int ntaps)
+{
+    double params[] = {gain, sampling_freq, symbol_rate, alpha, (double)ntaps};
+    std::string key = make_key("rrc", 5, params);
+    std::vector<float> taps;
+    if(lookup(key, taps))
+        return taps;
+    taps = gr::filter::firdes::root_raised_cosine(gain, sampling_freq, symbol_rate, alpha, ntaps);
+    store(key, taps);
+    return taps;
+}
+
+bool gr_taps_cache::is_dirty()
+{
+    gr::thread::scoped_lock guard(_mutex);
+    return _dirty;
+}
+
+/**
+ * File layout, native endianness: magic "QRLT", uint32 version,
+ * uint32 entry count, then per entry uint8 kind (0 real, 1 complex),
+ * uint16 key length, key, uint32 tap count and the raw float taps.
+ */
+bool gr_taps_cache::load(const std::string &path)
+{
+    std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+    if(!file.is_open())
+        return false;
+    char magic[4];
+    uint32_t version = 0;
+    uint32_t entries = 0;
+    file.read(magic, 4);
+    file.read((char*)&version, sizeof(version));
+    file.read((char*)&entries, sizeof(entries));
+    if(!file.good() || memcmp(magic, TAPS_CACHE_MAGIC, 4) != 0 || version != TAPS_CACHE_VERSION)
+    {
+        std::cerr << "Ignoring invalid filter taps cache " << path << std::endl;
+        return false;
+    }
+
+    std::map<std::string, std::vector<float> > real_taps;
+    std::map<std::string, std::vector<gr_complex> > complex_taps;
+    for(uint32_t i=0;i<entries;i++)
+    {
+        uint8_t kind = 0;
+        uint16_t key_len = 0;
+        uint32_t ntaps = 0;
+        file.read((char*)&kind, sizeof(kind));
+        file.read((char*)&key_len, sizeof(key_len));
+        if(!file.good())
+            return false;
+        std::string key(key_len, '\0');
+        file.read(&key[0], key_len);
+        file.read((char*)&ntaps, sizeof(ntaps));
+        if(!file.good() || ntaps > 1000000)
+            return false;
+        if(kind == 0)
+        {
+            std::vector<float> taps(ntaps);
+            if(ntaps > 0)
+                file.read((char*)&taps[0], ntaps * sizeof(float));
+            real_taps[key] = taps;
+        }
+        else
+        {
+            std::vector<gr_complex> taps(ntaps);
+            if(ntaps > 0)
+                file.read((char*)&taps[0], ntaps * sizeof(gr_complex));
+            complex_taps[key] = taps;
+        }
+        if(!file.good())
+            return false;
+    }
+
+    gr::thread::scoped_lock guard(_mutex);
+    _real_taps.insert(real_taps.begin(), real_taps.end());
+    _complex_taps.insert(complex_taps.begin(), complex_taps.end());
+    return true;
+}
+
+bool gr_taps_cache::save(const std::string &path)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    std::ofstream file(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if(!file.is_open())
+    {
+        std::cerr << "Could not write filter taps cache " << path << std::endl;
+        return false;
+    }
+    uint32_t entries = _real_taps.size() + _complex_taps.size();
+    file.write(TAPS_CACHE_MAGIC, 4);
+    file.write((const char*)&TAPS_CACHE_VERSION, sizeof(TAPS_CACHE_VERSION));
+    file.write((const char*)&entries, sizeof(entries));
+    for(std::map<std::string, std::vector<float> >::const_iterator it = _real_taps.begin();
+        it != _real_taps.end(); ++it)
+    {
+        uint8_t kind = 0;
+        uint16_t key_len = it->first.size();
+        uint32_t ntaps = it->second.size();
+        file.write((const char*)&kind, sizeof(kind));
+        file.write((const char*)&key_len, sizeof(key_len));
+        file.write(it->first.data(), key_len);
+        file.write((const char*)&ntaps, sizeof(ntaps));
+        if(ntaps > 0)
+            file.write((const char*)&it->second[0], ntaps * sizeof(float));
+    }
+    for(std::map<std::string, std::vector<gr_complex> >::const_iterator it = _complex_taps.begin();
+        it != _complex_taps.end(); ++it)
+    {
+        uint8_t kind = 1;
+        uint16_t key_len = it->first.size();
+        uint32_t ntaps = it->second.size();
+        file.write((const char*)&kind, sizeof(kind));
+        file.write((const char*)&key_len, sizeof(key_len));
+        file.write(it->first.data(), key_len);
+        file.write((const char*)&ntaps, sizeof(ntaps));
+        if(ntaps > 0)
+            file.write((const char*)&it->second[0], ntaps * sizeof(gr_complex));
+    }
+    if(!file.good())
+        return false;
+    _dirty = false;
+    return true;
+}
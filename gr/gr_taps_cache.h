@@ -0,0 +1,83 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+
+#ifndef GR_TAPS_CACHE_H
+#define GR_TAPS_CACHE_H
+
+#include <gnuradio/filter/firdes.h>
+#include <gnuradio/thread/thread.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <iostream>
+
+/**
+ * @brief Process wide cache of designed filter taps.
+ *
+ * The methods take the same arguments as their gr::filter::firdes
+ * counterparts and only run the design once per distinct argument set.
+ * The cache can be loaded from and saved to a binary file so the work is
+ * also skipped across restarts.
+ */
+class gr_taps_cache
+{
+public:
+    static std::vector<float> low_pass(double gain, double sampling_freq, double cutoff_freq,
+                                       double transition_width,
+                                       gr::filter::firdes::win_type window=gr::filter::firdes::WIN_HAMMING,
+                                       double beta=6.76);
+    static std::vector<float> high_pass(double gain, double sampling_freq, double cutoff_freq,
+                                        double transition_width,
+                                        gr::filter::firdes::win_type window=gr::filter::firdes::WIN_HAMMING,
+                                        double beta=6.76);
+    static std::vector<float> band_pass(double gain, double sampling_freq, double low_cutoff_freq,
+                                        double high_cutoff_freq, double transition_width,
+                                        gr::filter::firdes::win_type window=gr::filter::firdes::WIN_HAMMING,
+                                        double beta=6.76);
+    static std::vector<gr_complex> complex_band_pass(double gain, double sampling_freq, double low_cutoff_freq,
+                                        double high_cutoff_freq, double transition_width,
+                                        gr::filter::firdes::win_type window=gr::filter::firdes::WIN_HAMMING,
+                                        double beta=6.76);
+    static std::vector<gr_complex> complex_band_pass_2(double gain, double sampling_freq, double low_cutoff_freq,
+                                        double high_cutoff_freq, double transition_width, double attenuation_dB,
+                                        gr::filter::firdes::win_type window=gr::filter::firdes::WIN_HAMMING,
+                                        double beta=6.76);
+    static std::vector<float> root_raised_cosine(double gain, double sampling_freq, double symbol_rate,
+                                                 double alpha, int ntaps);
+
+    static bool load(const std::string &path);
+    static bool save(const std::string &path);
+    static bool is_dirty();
+
+private:
+    static std::string make_key(const char *type, int count, const double *params);
+    static bool lookup(const std::string &key, std::vector<float> &taps);
+    static bool lookup(const std::string &key, std::vector<gr_complex> &taps);
+    static void store(const std::string &key, const std::vector<float> &taps);
+    static void store(const std::string &key, const std::vector<gr_complex> &taps);
+
+    static std::map<std::string, std::vector<float> > _real_taps;
+    static std::map<std::string, std::vector<gr_complex> > _complex_taps;
+    static gr::thread::mutex _mutex;
+    static bool _dirty;
+};
+
+#endif // GR_TAPS_CACHE_H
@@ -0,0 +1,125 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "gr_tx_gate_cc.h"
+
+gr_tx_gate_cc_sptr make_gr_tx_gate_cc(bool burst_tags, int drain_items)
+{
+    return gnuradio::get_initial_sptr(new gr_tx_gate_cc(burst_tags, drain_items));
+}
+
+gr_tx_gate_cc::gr_tx_gate_cc(bool burst_tags, int drain_items) :
+    gr::block("gr_tx_gate_cc",
+              gr::io_signature::make (1, 1, sizeof(gr_complex)),
+              gr::io_signature::make (1, 1, sizeof(gr_complex)))
+{
+    _state = GateClosed;
+    _burst_tags = burst_tags;
+    _in_burst = false;
+    _drain_items = drain_items;
+    _idle_items = 0;
+    // the burst tags are generated here, upstream tags are not forwarded
+    set_tag_propagation_policy(TPP_DONT);
+}
+
+void gr_tx_gate_cc::set_open(bool open)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    if(open)
+        _state = GateOpen;
+    else if(_state == GateOpen)
+    {
+        _state = GateClosing;
+        _idle_items = 0;
+    }
+}
+
+/// Number of consecutive empty samples after which a closing gate closes
+void gr_tx_gate_cc::set_drain(int drain_items)
+{
+    gr::thread::scoped_lock guard(_mutex);
+    _drain_items = drain_items;
+}
+
+/// False once a requested close has taken effect
+bool gr_tx_gate_cc::is_open()
+{
+    gr::thread::scoped_lock guard(_mutex);
+    return _state != GateClosed;
+}
+
+void gr_tx_gate_cc::forecast(int noutput_items, gr_vector_int &ninput_items_required)
+{
+    (void)noutput_items;
+    // between bursts there is nothing to send, so wait for the modulator;
+    // otherwise never wait, gaps are filled with zeros
+    gr::thread::scoped_lock guard(_mutex);
+    ninput_items_required[0] = (_burst_tags && (_state == GateClosed)) ? 1 : 0;
+}
+
+int gr_tx_gate_cc::general_work(int noutput_items,
+                                gr_vector_int &ninput_items,
+                                gr_vector_const_void_star &input_items,
+                                gr_vector_void_star &output_items)
+{
+    const gr_complex *in = (const gr_complex*)input_items[0];
+    gr_complex *out = (gr_complex*)output_items[0];
+    int available = ninput_items[0];
+
+    gr::thread::scoped_lock guard(_mutex);
+    if(_state == GateClosing)
+    {
+        // the gate polls, so one empty call is not the end of the
+        // transmission, only a whole drain interval without input is
+        if(available > 0)
+            _idle_items = 0;
+        else if(_idle_items >= _drain_items)
+            _state = GateClosed;
+    }
+    if(_state == GateClosed)
+    {
+        // anything still arriving is not keyed
+        consume(0, available);
+        if(_burst_tags)
+        {
+            if(!_in_burst)
+                return 0;
+            // one trailing zero carries the end of burst
+            out[0] = gr_complex(0, 0);
+            add_item_tag(0, nitems_written(0), pmt::string_to_symbol("tx_eob"), pmt::PMT_T);
+            _in_burst = false;
+            return 1;
+        }
+        memset(out, 0, noutput_items * sizeof(gr_complex));
+        return noutput_items;
+    }
+    if(_burst_tags && !_in_burst)
+    {
+        add_item_tag(0, nitems_written(0), pmt::string_to_symbol("tx_sob"), pmt::PMT_T);
+        _in_burst = true;
+    }
+    if(available == 0)
+    {
+        memset(out, 0, noutput_items * sizeof(gr_complex));
+        if(_state == GateClosing)
+            _idle_items += noutput_items;
+        return noutput_items;
+    }
+    int n = std::min(noutput_items, available);
+    memcpy(out, in, n * sizeof(gr_complex));
+    consume(0, n);
+    return n;
+}
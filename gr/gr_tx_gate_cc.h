@@ -0,0 +1,74 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef GR_TX_GATE_CC_H
+#define GR_TX_GATE_CC_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/io_signature.h>
+#include <gnuradio/gr_complex.h>
+#include <pmt/pmt.h>
+#include <string.h>
+#include <algorithm>
+
+class gr_tx_gate_cc;
+typedef boost::shared_ptr<gr_tx_gate_cc> gr_tx_gate_cc_sptr;
+
+gr_tx_gate_cc_sptr make_gr_tx_gate_cc(bool burst_tags=false, int drain_items=0);
+
+/**
+ * @brief Keys the transmitter without stopping the flowgraph.
+ *
+ * While the gate is open and no modulated samples are waiting, zeros are
+ * sent to the device, so a transmission never underruns. Closing waits
+ * until no modulated samples have arrived for drain_items samples, so a
+ * short gap in the modulator does not cut off the end of a transmission. With burst tags the transmission is framed by tx_sob and tx_eob
+ * tags and nothing is sent while closed, for devices that handle bursts.
+ * Without them the closed gate keeps sending zeros, so the sink streams
+ * continuously and PTT only flips the gate state.
+ * The output buffer should be kept small, its length is the keying delay.
+ */
+class gr_tx_gate_cc : public gr::block
+{
+public:
+    gr_tx_gate_cc(bool burst_tags, int drain_items);
+
+    void forecast(int noutput_items, gr_vector_int &ninput_items_required);
+    int general_work(int noutput_items,
+                     gr_vector_int &ninput_items,
+                     gr_vector_const_void_star &input_items,
+                     gr_vector_void_star &output_items);
+
+    void set_open(bool open);
+    bool is_open();
+    void set_drain(int drain_items);
+
+private:
+    enum
+    {
+        GateClosed,
+        GateOpen,
+        GateClosing
+    };
+    int _state;
+    bool _burst_tags;
+    bool _in_burst;
+    int _drain_items;
+    int _idle_items;
+    gr::thread::mutex _mutex;
+};
+
+#endif // GR_TX_GATE_CC_H
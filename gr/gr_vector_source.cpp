@@ -56,6 +56,13 @@ int gr_vector_source::set_data(std::vector<unsigned char> *data)
     }
 }
 
+/// True once everything handed to set_data has been sent downstream
+bool gr_vector_source::is_idle()
+{
+    gr::thread::scoped_lock guard(_mutex);
+    return _finished;
+}
+
 int gr_vector_source::work(int noutput_items,
        gr_vector_const_void_star &input_items,
        gr_vector_void_star &output_items)
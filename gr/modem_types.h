@@ -19,6 +19,142 @@ namespace gr_modem_types {
         ModemTypeBPSK1000,
         ModemTypeQPSK250000,
     };
+
+    enum
+    {
+        CodecNone,
+        CodecCodec2,
+        CodecOpus
+    };
+
+    enum
+    {
+        Codec2Mode3200,
+        Codec2Mode2400,
+        Codec2Mode1600,
+        Codec2Mode1400,
+        Codec2Mode1300,
+        Codec2Mode700B,
+        Codec2Mode700C,
+        Codec2ModeCount
+    };
+
+    /// Samples per audio block handed to the vocoder, 40 ms @ 8 kHz
+    const int VoiceBlockSamples = 320;
+
+    struct codec2_mode_info
+    {
+        int mode;
+        int bitrate;
+        int frame_samples;
+        int frame_bits;
+        bool auto_select; // candidate for best_codec2_mode()
+    };
+
+    /// Sorted by descending bitrate
+    static const codec2_mode_info codec2_modes[] =
+    {
+        {Codec2Mode3200, 3200, 160, 64, true},
+        {Codec2Mode2400, 2400, 160, 48, true},
+        {Codec2Mode1600, 1600, 320, 64, true},
+        {Codec2Mode1400, 1400, 320, 56, true},
+        {Codec2Mode1300, 1300, 320, 52, true},
+        {Codec2Mode700B, 700, 320, 28, true},
+        {Codec2Mode700C, 700, 320, 28, false}, // needs a newer libcodec2
+    };
+
+    struct modem_info
+    {
+        int modem_type;
+        int codec;
+        int codec2_mode; // default vocoder mode for CodecCodec2
+        int bitrate; // voice bits per second on air, used for vocoder selection
+        int sync_bytes; // voice sync word
+        int frame_start_bytes; // start marker or reserved byte after the sync word
+        int frame_length; // payload bytes when not set by the codec2 mode
+    };
+
+    /// Adding a modem or changing its vocoder is one row here
+    static const modem_info modems[] =
+    {
+        {ModemTypeBPSK2000, CodecCodec2, Codec2Mode1400, 2000, 2, 1, 0},
+        {ModemTypeQPSK20000, CodecOpus, -1, 0, 2, 1, 47},
+        {ModemTypeQPSKVideo, CodecNone, -1, 0, 2, 1, 3122},
+        {ModemType4FSK20000, CodecOpus, -1, 0, 2, 1, 47},
+        {ModemType4FSK2000, CodecCodec2, Codec2Mode1400, 2000, 2, 1, 0},
+        {ModemTypeQPSK2000, CodecCodec2, Codec2Mode1400, 2000, 2, 1, 0},
+        {ModemTypeNBFM2500, CodecNone, -1, 0, 0, 0, 0},
+        {ModemTypeNBFM5000, CodecNone, -1, 0, 0, 0, 0},
+        {ModemTypeWBFM, CodecNone, -1, 0, 0, 0, 0},
+        {ModemTypeSSB2500, CodecNone, -1, 0, 0, 0, 0},
+        {ModemTypeAM5000, CodecNone, -1, 0, 0, 0, 0},
+        {ModemType2FSK2000, CodecCodec2, Codec2Mode1400, 2000, 2, 1, 0},
+        {ModemTypeBPSK1000, CodecCodec2, Codec2Mode700B, 1000, 1, 0, 0},
+        {ModemTypeQPSK250000, CodecNone, -1, 0, 2, 1, 1512},
+    };
+
+    inline const modem_info *get_modem_info(int modem_type)
+    {
+        for(unsigned int i=0;i<sizeof(modems)/sizeof(modems[0]);i++)
+        {
+            if(modems[i].modem_type == modem_type)
+                return &modems[i];
+        }
+        return 0;
+    }
+
+    inline const codec2_mode_info *get_codec2_mode_info(int codec2_mode)
+    {
+        for(unsigned int i=0;i<sizeof(codec2_modes)/sizeof(codec2_modes[0]);i++)
+        {
+            if(codec2_modes[i].mode == codec2_mode)
+                return &codec2_modes[i];
+        }
+        return 0;
+    }
+
+    /// Bytes produced by one voice block, each vocoder frame is byte aligned
+    inline int codec2_block_bytes(int codec2_mode)
+    {
+        const codec2_mode_info *info = get_codec2_mode_info(codec2_mode);
+        if(!info)
+            return 0;
+        return (VoiceBlockSamples / info->frame_samples) * ((info->frame_bits + 7) / 8);
+    }
+
+    /**
+     * Highest bitrate vocoder mode whose frames, including sync word and
+     * start marker once per superframe of voice_frames blocks, fit the
+     * bitrate of the modem.
+     */
+    inline int best_codec2_mode(int modem_type, int voice_frames)
+    {
+        const modem_info *modem = get_modem_info(modem_type);
+        if(!modem || (modem->codec != CodecCodec2))
+            return -1;
+        for(unsigned int i=0;i<sizeof(codec2_modes)/sizeof(codec2_modes[0]);i++)
+        {
+            if(!codec2_modes[i].auto_select)
+                continue;
+            long bits = 8L * (voice_frames * codec2_block_bytes(codec2_modes[i].mode)
+                              + modem->sync_bytes + modem->frame_start_bytes);
+            // one voice block lasts 40 ms
+            if(bits * 25 <= (long)modem->bitrate * voice_frames)
+                return codec2_modes[i].mode;
+        }
+        return modem->codec2_mode;
+    }
+
+    /// Payload bytes of one frame for the modem, given its vocoder mode
+    inline int frame_length(int modem_type, int codec2_mode)
+    {
+        const modem_info *modem = get_modem_info(modem_type);
+        if(!modem)
+            return 0;
+        if(modem->codec == CodecCodec2)
+            return codec2_block_bytes(codec2_mode);
+        return modem->frame_length;
+    }
 }
 
 #endif // MODEM_TYPES_H
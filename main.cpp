@@ -27,6 +27,11 @@
 #include <QFile>
 #include <QtGlobal>
 #include <QTextStream>
+#include <QSocketNotifier>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
 #include "dtmfdecoder.h"
 #include "databaseapi.h"
 #include "serverwrapper.h"
@@ -40,8 +45,9 @@
 #include "station.h"
 #include "channel.h"
 #include "radioop.h"
+#include "gateway.h"
 #include <gnuradio/qtgui/const_sink_c.h>
-#include <gnuradio/qtgui/sink_c.h>
+#include <gnuradio/qtgui/vector_sink_f.h>
 #include <gnuradio/qtgui/number_sink.h>
 
 #if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
@@ -71,6 +77,33 @@ void logMessage(QtMsgType type, const char *msg)
     ts << txt << endl;
 }
 
+static int quit_fds[2];
+
+/// Only async signal safe work here, the event loop picks up the byte
+static void quitSignalHandler(int)
+{
+    char c = 1;
+    ssize_t written = ::write(quit_fds[0], &c, sizeof(c));
+    Q_UNUSED(written);
+}
+
+/// SIGINT and SIGTERM end the event loop of a headless process cleanly
+static bool setupQuitSignals(QCoreApplication *app)
+{
+    if(::socketpair(AF_UNIX, SOCK_STREAM, 0, quit_fds))
+        return false;
+    QSocketNotifier *notifier = new QSocketNotifier(quit_fds[1], QSocketNotifier::Read, app);
+    QObject::connect(notifier, SIGNAL(activated(int)), app, SLOT(quit()));
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = quitSignalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGINT, &action, 0);
+    sigaction(SIGTERM, &action, 0);
+    return true;
+}
+
 int main(int argc, char *argv[])
 {
 #if 0
@@ -83,15 +116,35 @@ int main(int argc, char *argv[])
 
     typedef QVector<Station> StationList;
     qRegisterMetaType<StationList>("StationList");
+    qRegisterMetaType<Station>("Station");
+    qRegisterMetaType<ByteFrame>("ByteFrame");
+    qRegisterMetaType<PcmFrame>("PcmFrame");
+    qRegisterMetaType<FloatFrame>("FloatFrame");
 
 
+    Settings *settings = new Settings;
+    settings->readConfig();
+    if(settings->_gateway_mode)
+    {
+        // headless, no display needed on the gateway box
+        QCoreApplication app(argc, argv);
+        if(!setupQuitSignals(&app))
+            qDebug() << "Could not install the signal handlers, gateway can not be stopped cleanly";
+        Gateway *gateway = new Gateway(settings);
+        gateway->start();
+        int ret = app.exec();
+        qDebug() << "Stopping gateway";
+        // joins the radio threads before the Mumble clients go away
+        gateway->stop();
+        delete gateway;
+        return ret;
+    }
+
     QApplication a(argc, argv);
 
     QString start_time= QDateTime::currentDateTime().toString("d/MMM/yyyy hh:mm:ss");
     qDebug() << start_time;
     DatabaseApi db;
-    Settings *settings = new Settings;
-    settings->readConfig();
     MumbleClient *client = new MumbleClient(settings);
     MainWindow *w = new MainWindow(settings);
     w->setWindowTitle("QRadioLink");
@@ -190,11 +243,13 @@ int main(int argc, char *argv[])
             "color: #FF6905;}");
 
     const std::string fft_name = "fft";
-    gr::qtgui::sink_c::sptr fft_gui = gr::qtgui::sink_c::make(8096,gr::filter::firdes::WIN_BLACKMAN_HARRIS,
-                                                          0,1000000,fft_name,true,true,true,false,w->get_fft_gui());
+    // plots the averaged dB frames of the demodulator's spectrum engine,
+    // RadioOp moves the frequency axis with the tuning
+    gr::qtgui::vector_sink_f::sptr fft_gui = gr::qtgui::vector_sink_f::make(8192, -500000, 1000000.0 / 8192,
+                                                          "Frequency (Hz)", "Power (dB)", fft_name, 1, w->get_fft_gui());
 
     fft_gui->set_update_time(0.1);
-    fft_gui->set_fft_power_db(-140,0);
+    fft_gui->set_y_axis(-140,0);
     QRect xy = w->geometry();
     w->get_fft_gui()->resize(xy.right() -xy.left(),xy.bottom()-xy.top()-100);
     fft_gui->qwidget()->resize(xy.right() -xy.left()-50,xy.bottom()-xy.top()-206);
@@ -218,25 +273,12 @@ int main(int argc, char *argv[])
                 qproperty-marker_alpha3: 150; \
                 qproperty-axes_label_font_size: 12; \
                 } \
-                WaterfallDisplayPlot { \
-                qproperty-intensity_color_map_type1: 5; \
-                    qproperty-low_intensity_color: #0B0041; \
-                qproperty-high_intensity_color: #FFFB00; \
-                } \
-                FrequencyDisplayPlot { \
-                    qproperty-marker_lower_intensity_color: white; \
-                        qproperty-marker_upper_intensity_color: black; \
-                        qproperty-marker_lower_intensity_visible: false; \
-                        qproperty-marker_upper_intensity_visible: true; \
-                        qproperty-marker_noise_floor_amplitude_color: red; \
-                    qproperty-marker_noise_floor_amplitude_visible: true; \
-            } \
                 ");
-    fft_gui->enable_rf_freq(true);
 
     QThread *t4 = new QThread;
     t4->setObjectName("radioop");
     RadioOp *radio_op = new RadioOp(settings, fft_gui,const_gui, rssi_gui);
+    radio_op->setVoipSource(client->voice());
     radio_op->moveToThread(t4);
     QObject::connect(t4, SIGNAL(started()), radio_op, SLOT(run()));
     QObject::connect(radio_op, SIGNAL(finished()), t4, SLOT(quit()));
@@ -255,6 +297,8 @@ int main(int argc, char *argv[])
     QObject::connect(w,SIGNAL(tuneTxFreq(qint64)),radio_op,SLOT(tuneTxFreq(qint64)));
     QObject::connect(w,SIGNAL(startAutoTuneFreq()),radio_op,SLOT(startAutoTune()));
     QObject::connect(w,SIGNAL(stopAutoTuneFreq()),radio_op,SLOT(stopAutoTune()));
+    QObject::connect(w,SIGNAL(startScan(qint64,qint64,int)),radio_op,SLOT(startScan(qint64,qint64,int)));
+    QObject::connect(w,SIGNAL(stopScan()),radio_op,SLOT(stopScan()));
     QObject::connect(w,SIGNAL(fineTuneFreq(long)),radio_op,SLOT(fineTuneFreq(long)));
     QObject::connect(w,SIGNAL(setTxPower(int)),radio_op,SLOT(setTxPower(int)));
     QObject::connect(w,SIGNAL(setRxSensitivity(int)),radio_op,SLOT(setRxSensitivity(int)));
@@ -276,10 +320,13 @@ int main(int argc, char *argv[])
     QObject::connect(radio_op, SIGNAL(displayDataReceiveStatus(bool)), w, SLOT(displayDataReceiveStatus(bool)));
     QObject::connect(radio_op, SIGNAL(freqFromGUI(long)), w, SLOT(updateFreqGUI(long)));
     QObject::connect(radio_op, SIGNAL(pingServer()), client, SLOT(pingServer()));
-    QObject::connect(client, SIGNAL(pcmAudio(short*,int,quint64)), radio_op, SLOT(processVoipAudioFrame(short*, int, quint64)));
-    QObject::connect(radio_op, SIGNAL(voipData(short*,int)), client, SLOT(processAudio(short*,int)));
+    // the voice thread queues the audio itself, no hop through an event loop
+    QObject::connect(radio_op, SIGNAL(voipData(PcmFrame)), client->voice(), SLOT(sendAudio(PcmFrame)),
+                     Qt::DirectConnection);
 
-    QObject::connect(client,SIGNAL(onlineStations(StationList)),w,SLOT(updateOnlineStations(StationList)));
+    QObject::connect(client,SIGNAL(stationAdded(Station)),w,SLOT(addStation(Station)));
+    QObject::connect(client,SIGNAL(stationChanged(Station)),w,SLOT(updateStation(Station)));
+    QObject::connect(client,SIGNAL(stationRemoved(int)),w,SLOT(removeStation(int)));
     QObject::connect(client,SIGNAL(textMessage(QString)),w,SLOT(displayText(QString)));
     QObject::connect(client,SIGNAL(newChannel(Channel*)),w,SLOT(newChannel(Channel*)));
 
@@ -63,6 +63,7 @@ MainWindow::MainWindow(Settings *settings, QWidget *parent) :
     QObject::connect(ui->rxModemTypeComboBox,SIGNAL(currentIndexChanged(int)),this,SLOT(toggleRxMode(int)));
     QObject::connect(ui->txModemTypeComboBox,SIGNAL(currentIndexChanged(int)),this,SLOT(toggleTxMode(int)));
     QObject::connect(ui->autotuneButton,SIGNAL(toggled(bool)),this,SLOT(autoTune(bool)));
+    QObject::connect(ui->scanButton,SIGNAL(toggled(bool)),this,SLOT(toggleScan(bool)));
     QObject::connect(ui->saveOptionsButton,SIGNAL(clicked()),this,SLOT(saveConfig()));
     QObject::connect(ui->tabWidget,SIGNAL(currentChanged(int)),this,SLOT(mainTabChanged(int)));
     QObject::connect(ui->comboBoxRxCTCSS,SIGNAL(currentIndexChanged(int)),this,SLOT(updateRxCTCSS(int)));
@@ -244,28 +245,34 @@ void MainWindow::GUIdisconnectVOIP()
 }
 
 
-void MainWindow::updateOnlineStations(StationList stations)
+void MainWindow::addStation(Station s)
 {
-    for(int i=0;i<stations.size();i++)
+    QList<QTreeWidgetItem*> channel_list = ui->voipTreeWidget->findItems(QString::number(s.channel_id),
+                                                                         Qt::MatchExactly | Qt::MatchRecursive,2);
+    if(channel_list.size()>0)
     {
-        QList<QTreeWidgetItem*> list = ui->voipTreeWidget->findItems(".", Qt::MatchRegExp | Qt::MatchExactly | Qt::MatchRecursive,3);
-        if(list.size()>0)
-        {
-            delete list.at(0);
-        }
+        QTreeWidgetItem *item = channel_list.at(0);
+        QTreeWidgetItem *st_item = new QTreeWidgetItem(0);
+        st_item->setText(0,s.callsign);
+        st_item->setText(3,QString::number(s.id));
+        item->addChild(st_item);
     }
-    for(int i=0;i<stations.size();i++)
+}
+
+void MainWindow::updateStation(Station s)
+{
+    // the station may have moved to another channel, so it is placed again
+    removeStation(s.id);
+    addStation(s);
+}
+
+void MainWindow::removeStation(int id)
+{
+    QList<QTreeWidgetItem*> list = ui->voipTreeWidget->findItems(QString::number(id),
+                                                                 Qt::MatchExactly | Qt::MatchRecursive,3);
+    if(list.size()>0)
     {
-        QList<QTreeWidgetItem*> channel_list = ui->voipTreeWidget->findItems(QString::number(stations.at(i).channel_id),
-                                                                             Qt::MatchExactly | Qt::MatchRecursive,2);
-        if(channel_list.size()>0)
-        {
-            QTreeWidgetItem *item = channel_list.at(0);
-            QTreeWidgetItem *st_item = new QTreeWidgetItem(0);
-            st_item->setText(0,stations.at(i).callsign);
-            st_item->setText(3,QString::number(stations.at(i).id));
-            item->addChild(st_item);
-        }
+        delete list.at(0);
     }
 }
 
@@ -418,6 +425,23 @@ void MainWindow::autoTune(bool value)
         emit stopAutoTuneFreq();
 }
 
+void MainWindow::toggleScan(bool value)
+{
+    if(!value)
+    {
+        emit stopScan();
+        return;
+    }
+    qint64 start_freq = _settings->_scan_start_freq;
+    qint64 stop_freq = _settings->_scan_stop_freq;
+    if((start_freq == 0) || (stop_freq <= start_freq))
+    {
+        start_freq = ui->frameCtrlFreq->getFrequency() - 500000;
+        stop_freq = ui->frameCtrlFreq->getFrequency() + 500000;
+    }
+    emit startScan(start_freq, stop_freq, _settings->_scan_step);
+}
+
 void MainWindow::displayImage(QImage img)
 {
     delete _video_img;
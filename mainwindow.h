@@ -52,7 +52,9 @@ public slots:
     void displayReceiveStatus(bool status);
     void displayTransmitStatus(bool status);
     void displayDataReceiveStatus(bool status);
-    void updateOnlineStations(StationList stations);
+    void addStation(Station s);
+    void updateStation(Station s);
+    void removeStation(int id);
     void toggleRXwin(bool value);
     void toggleTXwin(bool value);
     void tuneCenterFreq(int value);
@@ -65,6 +67,7 @@ public slots:
     void setSquelchDisplay(int value);
     void setVolumeDisplay(int value);
     void autoTune(bool value);
+    void toggleScan(bool value);
     void displayImage(QImage img);
     void enterFreq();
     void saveConfig();
@@ -102,6 +105,8 @@ signals:
     void enableGUIFFT(bool value);
     void startAutoTuneFreq();
     void stopAutoTuneFreq();
+    void startScan(qint64 start_freq, qint64 stop_freq, int step_hz);
+    void stopScan();
     void usePTTForVOIP(bool value);
     void setVOIPForwarding(bool value);
     void connectToServer(QString server, unsigned port);
@@ -23,11 +23,8 @@ MumbleClient::MumbleClient(Settings *settings, QObject *parent) :
     QObject(parent)
 {
     _telnet = new SSLClient;
-#ifndef NO_CRYPT
-    _crypt_state = new CryptState;
-#endif
-    _codec = new AudioEncoder;
     _settings = settings;
+    _telnet->setMaxWriteDelay(_settings->_mumble_tcp_write_delay);
     _encryption_set = false;
     _authenticated = false;
     _synchronized = false;
@@ -35,24 +32,40 @@ MumbleClient::MumbleClient(Settings *settings, QObject *parent) :
     _max_bandwidth = -1;
     _channel_id = -1;
     _temp_channel_name = "";
-    _sequence_number = 0;
+    // voice runs on its own thread so control traffic can not delay it
+    _voice = new UDPVoice(_settings);
+    _voice_thread = new QThread;
+    _voice_thread->setObjectName("udpvoice");
+    _voice->moveToThread(_voice_thread);
+    QObject::connect(_voice_thread, SIGNAL(started()), _voice, SLOT(run()));
+    QObject::connect(_voice, SIGNAL(finished()), _voice_thread, SLOT(quit()));
+    QObject::connect(_voice, SIGNAL(tunnelPacket(ByteFrame)), this, SLOT(sendTunnelPacket(ByteFrame)));
+    _voice_thread->start();
 }
 
 MumbleClient::~MumbleClient()
 {
+    // the voice thread uses the settings, join it before anything goes away
+    _voice->stop();
+    _voice_thread->wait();
+    delete _voice;
+    delete _voice_thread;
     delete _telnet;
-#ifndef NO_CRYPT
-    delete _crypt_state;
-#endif
-    delete _codec;
+}
+
+UDPVoice *MumbleClient::voice()
+{
+    return _voice;
 }
 
 void MumbleClient::connectToServer(QString address, unsigned port)
 {
     _telnet->connectHost(address,port);
+    _voice->setServer(address,port);
     QObject::connect(_telnet,SIGNAL(connectedToHost()),this,SLOT(sendVersion()));
-    QObject::connect(_telnet,SIGNAL(haveMessage(QByteArray)),this,SLOT(processProtoMessage(QByteArray)));
-    QObject::connect(_telnet,SIGNAL(haveUDPData(QByteArray)),this,SLOT(processUDPData(QByteArray)));
+    // direct, the message is only valid until the slot returns
+    QObject::connect(_telnet,SIGNAL(haveMessage(QByteArray)),this,SLOT(processProtoMessage(QByteArray)),
+                     Qt::DirectConnection);
 }
 
 void MumbleClient::disconnectFromServer()
@@ -62,11 +75,13 @@ void MumbleClient::disconnectFromServer()
         _telnet->disconnectHost();
         QObject::disconnect(_telnet,SIGNAL(connectedToHost()),this,SLOT(sendVersion()));
         QObject::disconnect(_telnet,SIGNAL(haveMessage(QByteArray)),this,SLOT(processProtoMessage(QByteArray)));
-        QObject::disconnect(_telnet,SIGNAL(haveUDPData(QByteArray)),this,SLOT(processUDPData(QByteArray)));
         _encryption_set = false;
         _authenticated = false;
         _synchronized = false;
         _session_id = -1;
+        _voice->setActive(false);
+        qDeleteAll(_stations);
+        _stations.clear();
         std::cout << "Disconnected" << std::endl;
     }
 }
@@ -131,15 +146,12 @@ void MumbleClient::pingServer()
 void MumbleClient::processProtoMessage(QByteArray data)
 {
 
-    int total_size = data.size();
-    quint8 bin_data[total_size];
-    unsigned char *temp = reinterpret_cast<unsigned char*>(data.data());
-    memcpy(bin_data,temp,total_size);
+    // parsed in place, the framer hands over exactly one message
+    const quint8 *bin_data = reinterpret_cast<const quint8*>(data.constData());
     int type, len;
     getPreamble(bin_data,&type,&len);
-    int message_size = total_size-6;
-    quint8 message[message_size];
-    memcpy(message,bin_data+6,message_size);
+    int message_size = data.size()-6;
+    const quint8 *message = bin_data+6;
     switch(type)
     {
     case 15:
@@ -163,43 +175,41 @@ void MumbleClient::processProtoMessage(QByteArray data)
         processUserRemove(message, message_size);
         break;
     case 1: // UDPTunnel
-        processIncomingAudioPacket(message, message_size, type);
+        _voice->receiveTunnel(ByteFrame(message, message_size));
         break;
     default:
         break;
     }
 }
 
-void MumbleClient::setupEncryption(quint8 *message, quint64 size)
+void MumbleClient::setupEncryption(const quint8 *message, quint64 size)
 {
     MumbleProto::CryptSetup crypt;
     crypt.ParseFromArray(message,size);
     _key = crypt.key();
     _client_nonce = crypt.client_nonce();
     _server_nonce = crypt.server_nonce();
-#ifndef NO_CRYPT
-    _crypt_state->setKey(reinterpret_cast<const unsigned char*>(_key.c_str()),
-                         reinterpret_cast<const unsigned char*>(_client_nonce.c_str()),
-                         reinterpret_cast<const unsigned char*>(_server_nonce.c_str()));
-#endif
+    _voice->setCryptKey(_key, _client_nonce, _server_nonce);
     _encryption_set = true;
     _authenticated = true;
     pingServer();
 }
 
-void MumbleClient::processServerSync(quint8 *message, quint64 size)
+void MumbleClient::processServerSync(const quint8 *message, quint64 size)
 {
     MumbleProto::ServerSync sync;
     sync.ParseFromArray(message,size);
     _session_id = sync.session();
     _max_bandwidth = sync.max_bandwidth();
-    std::string welcome = sync.welcome_text();
+    const std::string &welcome = sync.welcome_text();
     _synchronized = true;
+    _voice->setActive(true);
     QString msg;
     msg = QString::fromStdString(welcome)
              + " max bandwidth: " + _max_bandwidth
              + " session: " + QString::number(_session_id);
     emit textMessage(msg);
+    emit serverSynchronized();
     return;
 #ifndef NO_CRYPT
     //createChannel();
@@ -216,10 +226,10 @@ void MumbleClient::processServerSync(quint8 *message, quint64 size)
     sendMessage(data,9,msize);
 }
 
-void MumbleClient::processChannelState(quint8 *message, quint64 size)
+void MumbleClient::processChannelState(const quint8 *message, quint64 size)
 {
 
-    MumbleProto::ChannelState ch;
+    MumbleProto::ChannelState &ch = _channel_state;
     ch.ParseFromArray(message,size);
     Channel *c = new Channel(ch.channel_id(), ch.parent(), QString::fromStdString(ch.name()),
                                  QString::fromStdString(ch.description()));
@@ -228,10 +238,10 @@ void MumbleClient::processChannelState(quint8 *message, quint64 size)
 
 }
 
-void MumbleClient::processUserState(quint8 *message, quint64 size)
+void MumbleClient::processUserState(const quint8 *message, quint64 size)
 {
 
-    MumbleProto::UserState us;
+    MumbleProto::UserState &us = _user_state;
     us.ParseFromArray(message,size);
     if((_session_id==-1) && (us.has_channel_id()))
     {
@@ -250,108 +260,83 @@ void MumbleClient::processUserState(quint8 *message, quint64 size)
             {
                 emit channelReady(_channel_id);
             }
-            for(int i=0; i < _stations.size();i++)
+            Station *s = _stations.value(_session_id, 0);
+            if(s)
             {
-                Station *s = _stations.at(i);
-                if(s->id == _session_id)
-                {
-                    s->channel_id = us.channel_id();
-                }
+                s->channel_id = us.channel_id();
+                emit stationChanged(*s);
             }
         }
     }
 
     else
     {
-        bool set_station = false;
-        for(int i=0; i < _stations.size();i++)
+        Station *s = _stations.value(us.session(), 0);
+        if(s)
         {
-            Station *s = _stations.at(i);
-            if(s->id == us.session())
-            {
-                if(us.has_channel_id())
-                    s->channel_id = us.channel_id();
-                if(us.has_name())
-                    s->callsign = QString::fromStdString(us.name());
-                if(us.has_self_mute())
-                    s->mute = us.self_mute();
-                if(us.has_deaf())
-                    s->deaf = us.self_deaf();
-                if(us.has_comment())
-                    s->callsign += QString::fromStdString(us.comment());
-                set_station = true;
-            }
+            Station old = *s;
+            setStationState(s, us);
+            if((s->channel_id != old.channel_id) || (s->callsign != old.callsign) ||
+                    (s->mute != old.mute) || (s->deaf != old.deaf))
+                emit stationChanged(*s);
         }
-        if(!set_station)
+        else
         {
-            Station *s = new Station;
+            s = new Station;
             s->id = us.session();
-            if(us.has_name())
-                s->callsign = QString::fromStdString(us.name());
-            if(us.has_channel_id())
-                s->channel_id = us.channel_id();
-            if(us.has_self_mute())
-                s->mute = us.self_mute();
-            if(us.has_deaf())
-                s->deaf = us.self_deaf();
-            if(us.has_comment())
-                s->callsign += QString::fromStdString(us.comment());
-            _stations.push_back(s);
+            setStationState(s, us);
+            _stations.insert(s->id, s);
             emit newStation(s);
+            emit stationAdded(*s);
         }
     }
     /* Just debug code
-    for(int i = 0;i < _stations.size();i++)
+    foreach(Station *s, _stations)
     {
-        Station *s = _stations.at(i);
         qDebug() << "Session: " << QString::number(s->_id)
                  << " radio_id: " << s->_radio_id << " channel: "
                  << QString::number(s->_conference_id) << s->_callsign;
     }
     */
 
-    StationList sl;
-    for(int i =0;i<_stations.size();++i)
-    {
-        sl.append(*(_stations.at(i)));
-    }
-    emit onlineStations(sl);
+}
 
+/// Applies the fields present in a UserState message
+void MumbleClient::setStationState(Station *s, const MumbleProto::UserState &us)
+{
+    if(us.has_channel_id())
+        s->channel_id = us.channel_id();
+    if(us.has_name())
+        s->callsign = QString::fromStdString(us.name());
+    if(us.has_self_mute())
+        s->mute = us.self_mute();
+    if(us.has_deaf())
+        s->deaf = us.self_deaf();
+    if(us.has_comment())
+        s->callsign += QString::fromStdString(us.comment());
 }
 
-void MumbleClient::processUserRemove(quint8 *message, quint64 size)
+void MumbleClient::processUserRemove(const quint8 *message, quint64 size)
 {
 
-    MumbleProto::UserRemove us;
+    MumbleProto::UserRemove &us = _user_remove;
     us.ParseFromArray(message,size);
-    for(int i=0; i < _stations.size(); i++)
+    Station *s = _stations.take(us.session());
+    if(s)
     {
-        Station *s = _stations.at(i);
-        if(s->id == us.session())
-        {
-            emit leftStation(s);
-            usleep(1000000);
-            _stations.remove(i);
-            delete s;
-        }
+        emit leftStation(s);
+        emit stationRemoved(s->id);
+        delete s;
     }
     /* Just debug code
-    for(int i = 0;i < _stations.size();i++)
+    foreach(Station *s, _stations)
     {
-        Station *s = _stations.at(i);
         qDebug() << "Session: " << QString::number(s->_id)
                  << " radio_id: " << s->_radio_id << " channel: "
                  << QString::number(s->_conference_id) << s->_callsign;
     }
     */
 
-    StationList sl;
-    for(int i =0;i<_stations.size();++i)
-    {
-        sl.append(*(_stations.at(i)));
-    }
-    emit onlineStations(sl);
-
 }
 
 void MumbleClient::joinChannel(int id)
@@ -372,9 +357,10 @@ void MumbleClient::joinChannel(int id)
 int MumbleClient::callStation(QString radio_id)
 {
     int sessid = 0;
-    for(int i =0;i<_stations.size();i++)
+    QHash<int, Station*>::iterator it;
+    for(it = _stations.begin();it != _stations.end();++it)
     {
-        Station *s = _stations.at(i);
+        Station *s = it.value();
         if(s->radio_id == radio_id)
         {
             sessid = s->id;
@@ -422,9 +408,10 @@ void MumbleClient::disconnectFromCall()
 int MumbleClient::disconnectStation(QString radio_id)
 {
     int sessid = 0;
-    for(int i =0;i<_stations.size();i++)
+    QHash<int, Station*>::iterator it;
+    for(it = _stations.begin();it != _stations.end();++it)
     {
-        Station *s = _stations.at(i);
+        Station *s = it.value();
         if(s->radio_id == radio_id)
         {
             sessid = s->id;
@@ -455,9 +442,10 @@ int MumbleClient::disconnectStation(QString radio_id)
 void MumbleClient::disconnectAllStations()
 {
 
-    for(int i =0;i<_stations.size();i++)
+    QHash<int, Station*>::iterator it;
+    for(it = _stations.begin();it != _stations.end();++it)
     {
-        Station *s = _stations.at(i);
+        Station *s = it.value();
         if((s->called_by == _session_id) &&
                 (s->in_call == 1) &&
                 (s->channel_id == _channel_id))
@@ -549,130 +537,6 @@ void MumbleClient::setMute(bool mute)
     sendMessage(mdata,9,msize);
 }
 
-void MumbleClient::processAudio(short *audiobuffer, int audiobuffersize)
-{
-    if(!_synchronized)
-        return;
-    int packet_size = 0;
-    unsigned char *encoded_audio;
-    if(_settings->_use_codec2)
-    {
-        encoded_audio = _codec->encode_codec2(audiobuffer, audiobuffersize, packet_size);
-    }
-    else
-    {
-        encoded_audio = _codec->encode_opus(audiobuffer, audiobuffersize, packet_size);
-    }
-    createVoicePacket(encoded_audio, packet_size);
-    delete[] encoded_audio;
-    delete[] audiobuffer;
-}
-
-void MumbleClient::createVoicePacket(unsigned char *encoded_audio, int packet_size)
-{
-    int type = 0;
-    if(_settings->_use_codec2)
-        type |= (5 << 5);
-    else
-        type |= (4 << 5);
-
-    int data_size = 1024;
-    char data[data_size];
-    data[0] = static_cast<unsigned char>(type);
-    PacketDataStream pds(data + 1, data_size-1);
-    int nr_of_frames = opus_packet_get_nb_frames(encoded_audio,packet_size);
-
-    // sequence?
-
-    pds << _sequence_number;
-    int real_packet_size = packet_size;
-    _sequence_number +=nr_of_frames;
-    //packet_size |= 1 << 13;
-    pds << packet_size;
-
-    char *audio_packet = reinterpret_cast<char*>(encoded_audio);
-
-    pds.append(audio_packet,real_packet_size);
-
-    unsigned char *bin_data = reinterpret_cast<unsigned char*>(data);
-    if(_settings->_mumble_tcp) // TCP tunnel
-    {
-        sendMessage(bin_data,1,pds.size()+1);
-    }
-    else // Use UDP
-    {
-        sendUDPMessage(bin_data,pds.size()+1);
-    }
-}
-
-void MumbleClient::processIncomingAudioPacket(quint8 *data, quint64 size, quint8 type)
-{
-    PacketDataStream pds(data+1, size-1);
-    quint64 seq_number;
-    quint64 session;
-    quint8 audio_head;
-    pds >> session;
-    pds >> seq_number;
-    pds >> audio_head;
-    //audio_head &= 0x1fff;
-    if(type == 1) // Received UDPTunnel
-    {
-        type = audio_head >> 5;
-    }
-    int audio_size = pds.left();
-    if(audio_size <= 0)
-    {
-        qDebug() << "malformed audio frame";
-        return;
-    }
-    QByteArray qba = pds.dataBlock(pds.left());
-    unsigned char *encoded_audio = reinterpret_cast<unsigned char*>(qba.data());
-
-    decodeAudio(encoded_audio,audio_size, type, session);
-
-}
-
-void MumbleClient::processUDPData(QByteArray data)
-{
-    if(!_encryption_set)
-        return;
-    unsigned char *encrypted = reinterpret_cast<unsigned char*>(data.data());
-#ifndef NO_CRYPT
-    unsigned char decrypted[1024];
-    _crypt_state->decrypt(encrypted, decrypted, data.size());
-    int decrypted_length = data.size() - 4;
-
-    processIncomingAudioPacket(decrypted, decrypted_length);
-#else
-    quint8 type = data.at(0);
-    if(type == 32) // UDP ping reply
-        return;
-    type = type >> 5;
-    processIncomingAudioPacket(encrypted, data.size(), type);
-#endif
-}
-
-void MumbleClient::decodeAudio(unsigned char *audiobuffer, short audiobuffersize, quint8 type, quint64 session_id)
-{
-
-    int samples =0;
-    short *pcm = NULL;
-    if(type == 5)
-    {
-        pcm = _codec->decode_codec2(audiobuffer,audiobuffersize, samples);
-    }
-    else
-    {
-        pcm = _codec->decode_opus(audiobuffer,audiobuffersize, samples);
-    }
-    if(pcm == NULL)
-        return;
-    emit pcmAudio(pcm, samples, session_id);
-
-}
-
-
-
 void MumbleClient::sendMessage(quint8 *message, quint16 type, int size)
 {
 
@@ -687,42 +551,16 @@ void MumbleClient::sendMessage(quint8 *message, quint16 type, int size)
     _telnet->sendBin(bin_data,new_size);
 }
 
-void MumbleClient::sendUDPMessage(quint8 *message, int size)
+void MumbleClient::sendTunnelPacket(ByteFrame packet)
 {
-
-#ifndef NO_CRYPT
-    if(_encryption_set)
-    {
-        int new_size = size+4;
-        quint8 bin_data[new_size];
-        _crypt_state->encrypt(message,bin_data,size);
-        _telnet->sendUDP(bin_data,new_size);
-    }
-#else
-     _telnet->sendUDP(message,size);
-#endif
+    sendMessage(packet.data(),1,packet.size());
 }
 
 void MumbleClient::sendUDPPing()
 {
     if((!_synchronized) || (!_encryption_set))
         return;
-    quint8 head = 32;
-    struct timeval now;
-
-    gettimeofday(&now, NULL);
-    quint64 ts=now.tv_sec*1000000+now.tv_usec;
-    quint8 message[sizeof(quint8) + sizeof(quint64)];
-    memcpy(message,&head,sizeof(quint8));
-    memcpy(message+sizeof(quint8),&ts,sizeof(quint64));
-#ifndef NO_CRYPT
-    quint8 encrypted[sizeof(quint8) + sizeof(quint64)+4];
-    _crypt_state->encrypt(message,encrypted,sizeof(quint8) + sizeof(quint64));
-
-    _telnet->sendUDP(encrypted,sizeof(quint8) + sizeof(quint64)+4);
-#else
-    _telnet->sendUDP(message,sizeof(quint8) + sizeof(quint64));
-#endif
+    _voice->sendPing();
 }
 
 
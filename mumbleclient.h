@@ -20,16 +20,20 @@
 #include <QObject>
 #include <QString>
 #include <QVector>
+#include <QHash>
 #include <QDateTime>
 #include <QtEndian>
 #include <QCoreApplication>
+#include <QThread>
 #include <string>
 #include <sys/time.h>
 #include <unistd.h>
 #include "ext/Mumble.pb.h"
 #include "ext/PacketDataStream.h"
 #include "ext/utils.h"
+#include "ext/framebuffer.h"
 #include "sslclient.h"
+#include "udpvoice.h"
 #include "audio/audiointerface.h"
 #include "audio/audioencoder.h"
 #include "config_defines.h"
@@ -44,16 +48,20 @@ class MumbleClient : public QObject
 public:
     explicit MumbleClient(Settings *settings, QObject *parent = 0);
     ~MumbleClient();
+    UDPVoice *voice();
 
 
 signals:
     void channelName(QString name);
-    void pcmAudio(short *pcm, int size, quint64 session_id);
-    void onlineStations(StationList);
     void newStation(Station* s);
+    // incremental station list updates
+    void stationAdded(Station s);
+    void stationChanged(Station s);
+    void stationRemoved(int id);
     void newChannel(Channel* chan);
     void leftStation(Station*);
     void channelReady(int chan_number);
+    void serverSynchronized();
     void textMessage(QString msg);
     
 public slots:
@@ -63,9 +71,7 @@ public slots:
     void authenticate();
     void pingServer();
     void processProtoMessage(QByteArray data);
-    void processUDPData(QByteArray data);
     void sendUDPPing();
-    void processAudio(short *audiobuffer, int audiobuffersize);
     QString getChannelName();
     int getChannelId();
     QString createChannel(QString channel_name="");
@@ -75,24 +81,19 @@ public slots:
     int disconnectStation(QString radio_id);
     void disconnectAllStations();
     void setMute(bool mute);
+    void sendTunnelPacket(ByteFrame packet);
 
 private:
-    void sendUDPMessage(quint8 *message, int size);
     void sendMessage(quint8 *message, quint16 type, int size);
-    void setupEncryption(quint8 *message, quint64 size);
+    void setupEncryption(const quint8 *message, quint64 size);
 
-    void processServerSync(quint8 *message, quint64 size);
-    void processChannelState(quint8 *message, quint64 size);
-    void processUserState(quint8 *message, quint64 size);
-    void processUserRemove(quint8 *message, quint64 size);
-    void createVoicePacket(unsigned char *encoded_audio, int packet_size);
-    void processIncomingAudioPacket(quint8 *data, quint64 size, quint8 type);
-    void decodeAudio(unsigned char *audiobuffer, short audiobuffersize, quint8 type, quint64 session_id);
+    void processServerSync(const quint8 *message, quint64 size);
+    void processChannelState(const quint8 *message, quint64 size);
+    void processUserState(const quint8 *message, quint64 size);
+    void processUserRemove(const quint8 *message, quint64 size);
+    void setStationState(Station *s, const MumbleProto::UserState &us);
 
     SSLClient *_telnet;
-#ifndef NO_CRYPT
-    CryptState *_crypt_state;
-#endif
     std::string _key;
     std::string _client_nonce;
     std::string _server_nonce;
@@ -103,10 +104,15 @@ private:
     int _session_id;
     int _max_bandwidth;
     int _channel_id;
-    AudioEncoder *_codec;
     Settings *_settings;
-    quint64 _sequence_number;
-    QVector<Station*> _stations;
+    UDPVoice *_voice;
+    QThread *_voice_thread;
+    QHash<int, Station*> _stations; // by session id
+    // parse targets for the frequent state messages, reused so their
+    // string buffers are allocated once instead of for every message
+    MumbleProto::UserState _user_state;
+    MumbleProto::UserRemove _user_remove;
+    MumbleProto::ChannelState _channel_state;
 
 };
 
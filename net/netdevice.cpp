@@ -81,25 +81,23 @@ int NetDevice::tun_init()
     return 1;
 }
 
-unsigned char* NetDevice::read_buffered(int &nread)
+int NetDevice::read_buffered(unsigned char *buf, int size)
 {
-    unsigned char *buffer = new unsigned char[1500];
-    nread = read(_fd_tun,buffer,1500);
+    int nread = read(_fd_tun,buf,size);
     if(nread < 0)
     {
       qDebug() << "error reading from tap interface";
     }
-    return buffer;
+    return nread;
 }
 
-int NetDevice::write_buffered(unsigned char *data, int len)
+int NetDevice::write_buffered(const unsigned char *data, int len)
 {
     int nwrite = write(_fd_tun,data,len);
     if(nwrite < 0)
     {
       qDebug() << "error writing to tap interface";
     }
-    delete[] data;
     return nwrite;
 }
 
@@ -41,8 +41,8 @@ signals:
 public slots:
 
 public:
-    unsigned char* read_buffered(int &bytes);
-    int write_buffered(unsigned char* data, int len);
+    int read_buffered(unsigned char *buf, int size);
+    int write_buffered(const unsigned char* data, int len);
 
 private:
     int tun_init();
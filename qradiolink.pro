@@ -20,6 +20,10 @@ QMAKE_LFLAGS += $$(LDFLAGS)
 SOURCES += main.cpp\
         mainwindow.cpp\
         audio/audioencoder.cpp\
+        audio/jitterbuffer.cpp\
+        audio/voipmixer.cpp\
+        audio/dtmfdetector.cpp\
+        audio/transcoder.cpp\
         audio/audiointerface.cpp\
         audioop.cpp\
         controller.cpp\
@@ -32,6 +36,8 @@ SOURCES += main.cpp\
         settings.cpp\
         speech.cpp\
         sslclient.cpp\
+        udpvoice.cpp\
+        gateway.cpp\
         station.cpp\
         telnetclient.cpp\
         telnetserver.cpp\
@@ -74,10 +80,21 @@ SOURCES += main.cpp\
     gr/gr_audio_source.cpp \
     gr/gr_audio_sink.cpp \
     gr/gr_4fsk_discriminator.cpp \
-    channel.cpp
+    gr/gr_rssi_cf.cpp \
+    gr/gr_spectrum_cc.cpp \
+    gr/gr_taps_cache.cpp \
+    gr/gr_repeater.cpp \
+    gr/gr_mode_selector.cpp \
+    gr/gr_tx_gate_cc.cpp \
+    channel.cpp \
+    scanner.cpp
 
 HEADERS  += mainwindow.h\
         audio/audioencoder.h\
+        audio/jitterbuffer.h\
+        audio/voipmixer.h\
+        audio/dtmfdetector.h\
+        audio/transcoder.h\
         audio/audiointerface.h\
         audioop.h\
         controller.h\
@@ -90,12 +107,16 @@ HEADERS  += mainwindow.h\
         settings.h\
         speech.h\
         sslclient.h\
+        udpvoice.h\
+        gateway.h\
         station.h\
         telnetclient.h\
         telnetserver.h\
         config_defines.h\
         ext/agc.h\
         ext/dec.h\
+        ext/framebuffer.h\
+        ext/spscqueue.h\
         ext/Goertzel.h\
         ext/Mumble.pb.h\
         ext/murmur_pch.h\
@@ -136,8 +157,15 @@ HEADERS  += mainwindow.h\
     gr/gr_audio_source.h \
     gr/gr_audio_sink.h \
     gr/gr_4fsk_discriminator.h \
+    gr/gr_rssi_cf.h \
+    gr/gr_spectrum_cc.h \
+    gr/gr_taps_cache.h \
+    gr/gr_repeater.h \
+    gr/gr_mode_selector.h \
+    gr/gr_tx_gate_cc.h \
     gr/modem_types.h \
-    channel.h
+    channel.h \
+    scanner.h
 
 
 FORMS    += mainwindow.ui
@@ -145,7 +173,7 @@ FORMS    += mainwindow.ui
 
 LIBS += -lgnuradio-pmt -lgnuradio-audio -lgnuradio-analog -lgnuradio-blocks \
         -lgnuradio-osmosdr -lgsm \
-        -lgnuradio-blocks -lgnuradio-filter -lgnuradio-digital -lgnuradio-runtime -lgnuradio-qtgui -lgnuradio-fec \
+        -lgnuradio-blocks -lgnuradio-filter -lgnuradio-digital -lgnuradio-runtime -lgnuradio-qtgui -lgnuradio-fec -lgnuradio-fft \
         -lboost_thread$$BOOST_SUFFIX -lboost_system$$BOOST_SUFFIX -lboost_program_options$$BOOST_SUFFIX
 LIBS += -lrt  # need to include on some distros
 
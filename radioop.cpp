@@ -16,7 +16,7 @@
 
 #include "radioop.h"
 
-RadioOp::RadioOp(Settings *settings, gr::qtgui::sink_c::sptr fft_gui, gr::qtgui::const_sink_c::sptr const_gui,
+RadioOp::RadioOp(Settings *settings, gr::qtgui::vector_sink_f::sptr fft_gui, gr::qtgui::const_sink_c::sptr const_gui,
                  gr::qtgui::number_sink::sptr rssi_gui, QObject *parent) :
     QObject(parent)
 {
@@ -27,8 +27,11 @@ RadioOp::RadioOp(Settings *settings, gr::qtgui::sink_c::sptr fft_gui, gr::qtgui:
     _codec = new AudioEncoder;
     _audio = new AudioInterface;
     _mutex = new QMutex;
-    _m_queue = new std::vector<short>;
-    _last_session_id = 0;
+    _voip_mixer = new VoipMixer;
+    _voip_source = 0;
+    _voip_mix_time = 0;
+    _voip_tx_block = PcmFrame(AudioEncoder::MaxFrameSamples);
+    _voip_tx_samples = 0;
     _net_device = 0;
     _video = 0;
     _stop =false;
@@ -36,7 +39,9 @@ RadioOp::RadioOp(Settings *settings, gr::qtgui::sink_c::sptr fft_gui, gr::qtgui:
     _rx_inited = false;
     _voip_enabled = false;
     _voip_forwarding = false;
-    _last_voiced_frame_timer.start();
+    _voip_mix_timer.start();
+    _jitter_buffer = new JitterBuffer(40);
+    _jitter_timer.start();
     _voip_tx_timer = new QTimer(this);
     _voip_tx_timer->setSingleShot(true);
     _settings = settings;
@@ -44,7 +49,20 @@ RadioOp::RadioOp(Settings *settings, gr::qtgui::sink_c::sptr fft_gui, gr::qtgui:
     _process_text = false;
     _repeat_text = false;
     _repeat = false;
+    _transcode = false;
+    _tx_closing = false;
+    _tx_streaming = false;
+    // cross mode repeat decodes and encodes on its own thread
+    _transcoder = new Transcoder(settings);
+    _transcoder_thread = new QThread;
+    _transcoder_thread->setObjectName("transcoder");
+    _transcoder->moveToThread(_transcoder_thread);
+    QObject::connect(_transcoder_thread, SIGNAL(started()), _transcoder, SLOT(run()));
+    QObject::connect(_transcoder, SIGNAL(finished()), _transcoder_thread, SLOT(quit()));
+    _transcoder_thread->start();
     _settings = settings;
+    _codec->set_opus_profile(_settings->_opus_profile, _settings->_opus_bitrate,
+                             _settings->_opus_complexity, _settings->_opus_packet_loss);
     _tx_power = 0;
     _rx_sensitivity = 0;
     _rx_volume = 1.0;
@@ -58,7 +76,7 @@ RadioOp::RadioOp(Settings *settings, gr::qtgui::sink_c::sptr fft_gui, gr::qtgui:
     _step_hz = 1;
     _tuning_done = true;
     _tune_counter = 0;
-    _tx_modem_started = false;
+    _rx_paused = false;
     _voice_led_timer = new QTimer(this);
     _voice_led_timer->setSingleShot(true);
     _data_led_timer = new QTimer(this);
@@ -66,6 +84,7 @@ RadioOp::RadioOp(Settings *settings, gr::qtgui::sink_c::sptr fft_gui, gr::qtgui:
     _rand_frame_data = new unsigned char[5000];
     _voip_encode_buffer = new QVector<short>;
     _fft_gui = fft_gui;
+    _gateway = false;
     QObject::connect(_voice_led_timer, SIGNAL(timeout()), this, SLOT(receiveEnd()));
     QObject::connect(_data_led_timer, SIGNAL(timeout()), this, SLOT(receiveEnd()));
     QObject::connect(_voip_tx_timer, SIGNAL(timeout()), this, SLOT(stopTx()));
@@ -77,14 +96,19 @@ RadioOp::RadioOp(Settings *settings, gr::qtgui::sink_c::sptr fft_gui, gr::qtgui:
     QObject::connect(_modem,SIGNAL(dataFrameReceived()),this,SLOT(dataFrameReceived()));
     QObject::connect(_modem,SIGNAL(receiveEnd()),this,SLOT(receiveEnd()));
     QObject::connect(_modem,SIGNAL(endAudioTransmission()),this,SLOT(endAudioTransmission()));
-    QObject::connect(this,SIGNAL(audioData(unsigned char*,int)),_modem,SLOT(processAudioData(unsigned char*,int)));
-    QObject::connect(this,SIGNAL(pcmData(std::vector<float>*)),_modem,SLOT(processPCMAudio(std::vector<float>*)));
-    QObject::connect(this,SIGNAL(videoData(unsigned char*,int)),_modem,SLOT(processVideoData(unsigned char*,int)));
-    QObject::connect(this,SIGNAL(netData(unsigned char*,int)),_modem,SLOT(processNetData(unsigned char*,int)));
-    QObject::connect(_modem,SIGNAL(digitalAudio(unsigned char*,int)),this,SLOT(receiveAudioData(unsigned char*,int)));
-    QObject::connect(_modem,SIGNAL(pcmAudio(std::vector<float>*)),this,SLOT(receivePCMAudio(std::vector<float>*)));
-    QObject::connect(_modem,SIGNAL(videoData(unsigned char*,int)),this,SLOT(receiveVideoData(unsigned char*,int)));
-    QObject::connect(_modem,SIGNAL(netData(unsigned char*,int)),this,SLOT(receiveNetData(unsigned char*,int)));
+    QObject::connect(this,SIGNAL(audioData(ByteFrame)),_modem,SLOT(processAudioData(ByteFrame)));
+    QObject::connect(this,SIGNAL(pcmData(FloatFrame)),_modem,SLOT(processPCMAudio(FloatFrame)));
+    QObject::connect(this,SIGNAL(videoData(ByteFrame)),_modem,SLOT(processVideoData(ByteFrame)));
+    QObject::connect(this,SIGNAL(netData(ByteFrame)),_modem,SLOT(processNetData(ByteFrame)));
+    QObject::connect(_modem,SIGNAL(digitalAudio(ByteFrame)),this,SLOT(receiveAudioData(ByteFrame)));
+    QObject::connect(_modem,SIGNAL(pcmAudio(FloatFrame)),this,SLOT(receivePCMAudio(FloatFrame)));
+    QObject::connect(_modem,SIGNAL(videoData(ByteFrame)),this,SLOT(receiveVideoData(ByteFrame)));
+    QObject::connect(_modem,SIGNAL(netData(ByteFrame)),this,SLOT(receiveNetData(ByteFrame)));
+    _scanner = new Scanner(_modem, 1000000);
+    _scanner->setHangTime(_settings->_scan_hang_time);
+    _scanner->setThreshold(_settings->_scan_threshold);
+    QObject::connect(_scanner,SIGNAL(channelFound(qint64)),this,SLOT(scanChannelFound(qint64)));
+    QObject::connect(_scanner,SIGNAL(scanResumed()),this,SLOT(scanResumed()));
     for (int j = 0;j<5000;j++)
         _rand_frame_data[j] = rand() % 256;
 
@@ -97,6 +121,12 @@ RadioOp::~RadioOp()
     if(_tx_inited)
         toggleTX(false);
     delete _codec;
+    delete _jitter_buffer;
+    delete _voip_mixer;
+    _transcoder->stop();
+    _transcoder_thread->wait();
+    delete _transcoder;
+    delete _transcoder_thread;
     if(_video != 0)
         delete _video;
     if(_net_device != 0)
@@ -104,10 +134,24 @@ RadioOp::~RadioOp()
     delete _audio;
     delete _voice_led_timer;
     delete _data_led_timer;
+    delete _scanner;
     delete _modem;
     delete[] _rand_frame_data;
 }
 
+/**
+ * Binds this radio to one gateway channel, its devices and frequencies
+ * take the place of the ones from the main configuration.
+ * Call before the radio is moved to its thread.
+ */
+void RadioOp::setGatewayChannel(const GatewayChannel &channel)
+{
+    _gateway = true;
+    _gateway_channel = channel;
+    _tune_center_freq = channel.rx_frequency;
+    _tune_shift_freq = channel.tx_shift;
+}
+
 void RadioOp::stop()
 {
     _stop=true;
@@ -155,6 +199,15 @@ void RadioOp::readConfig(std::string &rx_device_args, std::string &tx_device_arg
         root.lookupValue("rx_volume", rx_volume);
         root.lookupValue("rx_frequency", rx_frequency);
         root.lookupValue("tx_shift", tx_shift);
+        if(_gateway)
+        {
+            rx_device_args = _gateway_channel.rx_device_args.toStdString();
+            tx_device_args = _gateway_channel.tx_device_args.toStdString();
+            rx_antenna = _gateway_channel.rx_antenna.toStdString();
+            tx_antenna = _gateway_channel.tx_antenna.toStdString();
+            rx_freq_corr = _gateway_channel.rx_freq_corr;
+            tx_freq_corr = _gateway_channel.tx_freq_corr;
+        }
         _callsign = QString::fromStdString(callsign);
         if(_callsign.size() < 7)
         {
@@ -177,7 +230,7 @@ void RadioOp::readConfig(std::string &rx_device_args, std::string &tx_device_arg
         {
             _tune_center_freq = rx_frequency;
         }
-        if(_tune_shift_freq == 0)
+        if(_tune_shift_freq == 0 && !_gateway)
         {
             _tune_shift_freq = tx_shift;
         }
@@ -202,7 +255,7 @@ void RadioOp::readConfig(std::string &rx_device_args, std::string &tx_device_arg
     }
 }
 
-void RadioOp::vox(short *audiobuffer, int audiobuffer_size)
+void RadioOp::vox(const short *audiobuffer, int audiobuffer_size)
 {
     double treshhold = -136;
     double hyst = 0.5;
@@ -225,7 +278,6 @@ void RadioOp::vox(short *audiobuffer, int audiobuffer_size)
     qDebug() << power;
     if((power < treshhold+hyst))
     {
-        delete[] audiobuffer;
         return;
     }
 }
@@ -233,49 +285,52 @@ void RadioOp::vox(short *audiobuffer, int audiobuffer_size)
 void RadioOp::processAudioStream()
 {
     int audiobuffer_size = 640; //40 ms @ 8k
-    short *audiobuffer = new short[audiobuffer_size/sizeof(short)];
-    _audio->read_short(audiobuffer,audiobuffer_size);
+    PcmFrame audiobuffer(audiobuffer_size/sizeof(short));
+    _audio->read_short(audiobuffer.data(),audiobuffer_size);
     if(_voip_enabled)
     {
-        emit voipData(audiobuffer,audiobuffer_size);
+        emit voipData(audiobuffer);
         return;
     }
-    txAudio(audiobuffer, audiobuffer_size);
+    txAudio(audiobuffer);
 }
 
-void RadioOp::txAudio(short *audiobuffer, int audiobuffer_size)
+void RadioOp::txAudio(PcmFrame audiobuffer)
 {
+    int audiobuffer_size = audiobuffer.size()*sizeof(short);
     if(_tx_radio_type == radio_type::RADIO_TYPE_ANALOG)
     {
-        std::vector<float> *pcm = new std::vector<float>;
-
-        for(unsigned int i=0;i<audiobuffer_size/sizeof(short);i++)
+        FloatFrame pcm(audiobuffer.size());
+        float *out = pcm.data();
+        const short *in = audiobuffer.constData();
+        for(int i=0;i<audiobuffer.size();i++)
         {
-            pcm->push_back((float)audiobuffer[i] / 32767.0f);
+            out[i] = (float)in[i] / 32767.0f;
         }
 
         emit pcmData(pcm);
-        delete[] audiobuffer;
         return;
     }
 
     int packet_size = 0;
-    unsigned char *encoded_audio;
-    if((_tx_mode == gr_modem_types::ModemTypeBPSK2000) ||
-            (_tx_mode == gr_modem_types::ModemType2FSK2000) ||
-            (_tx_mode == gr_modem_types::ModemType4FSK2000) ||
-            (_tx_mode == gr_modem_types::ModemTypeQPSK2000))
-        encoded_audio = _codec->encode_codec2(audiobuffer, audiobuffer_size, packet_size);
-    else if(_tx_mode == gr_modem_types::ModemTypeBPSK1000)
-        encoded_audio = _codec->encode_codec2_700(audiobuffer, audiobuffer_size, packet_size);
+    ByteFrame encoded_audio(AudioEncoder::MaxFrameBytes);
+    const gr_modem_types::modem_info *modem = gr_modem_types::get_modem_info(_tx_mode);
+    if(modem && (modem->codec == gr_modem_types::CodecCodec2))
+        packet_size = _codec->encode_codec2(audiobuffer.constData(), audiobuffer_size, encoded_audio.data(),
+                                            _modem->codec2Mode(_tx_mode));
     else
-        encoded_audio = _codec->encode_opus(audiobuffer, audiobuffer_size, packet_size);
-
-    unsigned char *data = new unsigned char[packet_size];
-    memcpy(data,encoded_audio,packet_size);
-    emit audioData(data,packet_size);
-    delete[] encoded_audio;
-    delete[] audiobuffer;
+    {
+        packet_size = _codec->encode_opus(audiobuffer.constData(), audiobuffer_size, encoded_audio.data());
+        // DTX packets carry only silence, leave them off the air
+        if(packet_size <= 2)
+            return;
+        // radio frames have a fixed length
+        packet_size = _codec->pad_opus(encoded_audio.data(), packet_size, AudioEncoder::OpusMaxPacketBytes);
+    }
+    if(packet_size <= 0)
+        return;
+    encoded_audio.resize(packet_size);
+    emit audioData(encoded_audio);
 }
 
 int RadioOp::processVideoStream(bool &frame_flag)
@@ -283,7 +338,9 @@ int RadioOp::processVideoStream(bool &frame_flag)
     unsigned int max_video_frame_size = 3122;
     unsigned long encoded_size;
 
-    unsigned char *videobuffer = (unsigned char*)calloc(max_video_frame_size, sizeof(unsigned char));
+    ByteFrame video_frame(max_video_frame_size);
+    unsigned char *videobuffer = video_frame.data();
+    memset(videobuffer, 0, max_video_frame_size);
 
     QElapsedTimer timer;
     qint64 microsec;
@@ -313,35 +370,29 @@ int RadioOp::processVideoStream(bool &frame_flag)
 
     }
 
-    emit videoData(videobuffer,max_video_frame_size);
+    emit videoData(video_frame);
     return 1;
 }
 
 void RadioOp::processNetStream()
 {
     int max_frame_size = 1512;
-    unsigned char *netbuffer = (unsigned char*)calloc(max_frame_size, sizeof(unsigned char));
-    int nread;
-    unsigned char *buffer = _net_device->read_buffered(nread);
+    ByteFrame net_frame(max_frame_size);
+    unsigned char *netbuffer = net_frame.data();
+    // the packet is read straight into the frame, after the length header
+    int nread = _net_device->read_buffered(&(netbuffer[12]), max_frame_size - 12);
 
     if(nread > 0)
     {
         memcpy(&(netbuffer[0]), &nread, 4);
         memcpy(&(netbuffer[4]), &nread, 4);
         memcpy(&(netbuffer[8]), &nread, 4);
-        memcpy(&(netbuffer[12]), buffer, nread);
         for(int k=nread+12,i=0;k<max_frame_size;k++,i++)
         {
             netbuffer[k] = _rand_frame_data[i];
         }
 
-        emit netData(netbuffer,max_frame_size);
-        delete[] buffer;
-    }
-    else
-    {
-        delete[] netbuffer;
-        delete[] buffer;
+        emit netData(net_frame);
     }
 }
 
@@ -350,55 +401,78 @@ void RadioOp::sendEndBeep()
     QFile resfile(":/res/end_beep.raw");
     if(resfile.open(QIODevice::ReadOnly))
     {
-        QByteArray *data = new QByteArray(resfile.readAll());
-        short *samples = (short*) data->data();
-        std::vector<float> *pcm = new std::vector<float>;
-
-        for(unsigned int i=0;i<data->size()/sizeof(short);i++)
+        QByteArray data = resfile.readAll();
+        const short *samples = (const short*) data.constData();
+        FloatFrame pcm(data.size()/sizeof(short));
+        float *out = pcm.data();
+        for(int i=0;i<pcm.size();i++)
         {
-            pcm->push_back((float)samples[i] / 32767.0f);
+            out[i] = (float)samples[i] / 32767.0f;
         }
 
         emit pcmData(pcm);
-        delete data;
     }
 }
 
 void RadioOp::startTx()
 {
-    if(_tx_inited)
+    if(!_tx_inited)
+        return;
+    // a streaming TX flowgraph runs as long as TX is enabled and keying
+    // only retunes the sink and opens the gate, otherwise it is started here
+    if(!_settings->_full_duplex && !_rx_paused && _rx_inited && !_repeat
+            && (_tx_mode != gr_modem_types::ModemTypeQPSK250000))
     {
-        if(_rx_inited && !_repeat && (_tx_mode != gr_modem_types::ModemTypeQPSK250000))
-            _modem->stopRX();
-        if(_tx_modem_started)
-            _modem->stopTX();
-        _modem->startTX();
-        usleep(100000);
-        _modem->tuneTx(_tune_center_freq + _tune_shift_freq);
-        _tx_modem_started = false;
-        if(_tx_radio_type == radio_type::RADIO_TYPE_DIGITAL)
-            _modem->startTransmission(_callsign);
+        _modem->stopRX();
+        _rx_paused = true;
     }
+    // the gate of a stopped flowgraph is always closed
+    bool restart = !_tx_streaming && !_modem->txGateOpen();
+    _tx_closing = false;
+    if(!_settings->_full_duplex)
+        _modem->tuneTx(_tune_center_freq + _tune_shift_freq);
+    _modem->setTxGate(true);
+    if(restart)
+        _modem->startTX();
+    if(_tx_radio_type == radio_type::RADIO_TYPE_DIGITAL)
+        _modem->startTransmission(_callsign);
 }
 
 void RadioOp::stopTx()
 {
-    if(_tx_inited)
+    if(!_tx_inited)
+        return;
+    if(_tx_radio_type == radio_type::RADIO_TYPE_DIGITAL)
+        _modem->endTransmission(_callsign);
+    if((_tx_radio_type == radio_type::RADIO_TYPE_ANALOG)
+            && ((_tx_mode == gr_modem_types::ModemTypeNBFM2500) || (_tx_mode == gr_modem_types::ModemTypeNBFM5000)))
     {
-        if(_tx_radio_type == radio_type::RADIO_TYPE_DIGITAL)
-            _modem->endTransmission(_callsign);
-        if((_tx_radio_type == radio_type::RADIO_TYPE_ANALOG)
-                && ((_tx_mode == gr_modem_types::ModemTypeNBFM2500) || (_tx_mode == gr_modem_types::ModemTypeNBFM5000)))
-        {
-            sendEndBeep();
-        }
-        usleep(1000000);
-        _modem->stopTX();
-        _modem->tuneTx(50000000);
-        _tx_modem_started = false;
-        if(_rx_inited && !_repeat)
-            _modem->startRX();
+        sendEndBeep();
     }
+    // finishTx closes the gate once the queued frames are out
+    _tx_closing = true;
+}
+
+/// Called from the run loop, completes a stopTx without blocking it
+void RadioOp::finishTx()
+{
+    if(!_tx_closing || !_modem->txIdle())
+        return;
+    _modem->setTxGate(false);
+    // the gate closes after the modulators have drained
+    if(_modem->txGateOpen())
+        return;
+    _tx_closing = false;
+    if(_settings->_full_duplex)
+        return;
+    // the device may be shared with RX, so it stops sending before RX resumes
+    if(_tx_streaming)
+        _modem->tuneTx(50000000);
+    else
+        _modem->stopTX();
+    if(_rx_paused && _rx_inited)
+        _modem->startRX();
+    _rx_paused = false;
 }
 
 void RadioOp::updateFrequency()
@@ -423,15 +497,16 @@ void RadioOp::run()
     {
         bool transmitting = _transmitting;
         QCoreApplication::processEvents();
+        playoutAudio();
+        mixVoipAudio();
+        if(_transcode)
+            transcodedAudio();
+        finishTx();
         if(_voip_encode_buffer->size() > 320)
         {
-            short *pcm = new short[320];
-            for(int i =0; i< 320;i++)
-            {
-                pcm[i] = _voip_encode_buffer->at(i);
-            }
+            PcmFrame pcm(_voip_encode_buffer->constData(), 320);
             _voip_encode_buffer->remove(0,320);
-            emit voipData(pcm,320*sizeof(short));
+            emit voipData(pcm);
         }
         int time = QDateTime::currentDateTime().toTime_t();
         if((time - last_ping_time) > 10)
@@ -475,7 +550,9 @@ void RadioOp::run()
             _mutex->unlock();
             if(rx_inited)
             {
-                if(!_tuning_done)
+                if(_scanner->isScanning())
+                    _scanner->process();
+                else if(!_tuning_done)
                     autoTune();
                 if(_rx_radio_type == radio_type::RADIO_TYPE_DIGITAL)
                     _modem->demodulate();
@@ -490,19 +567,9 @@ void RadioOp::run()
         {
             if(_tx_inited)
             {
-                if(!_tx_modem_started)
-                {
-                    stopTx();
-                    startTx();
-                }
-                else
-                {
-                    startTx();
-                }
-                _tx_modem_started = true;
-                _modem->startTransmission(_callsign);
+                startTx();
                 _modem->textData(_text_out);
-                _modem->endTransmission(_callsign);
+                stopTx();
             }
             if(!_repeat_text)
             {
@@ -521,31 +588,64 @@ void RadioOp::run()
     emit finished();
 }
 
-void RadioOp::receiveAudioData(unsigned char *data, int size)
+void RadioOp::receiveAudioData(ByteFrame data)
+{
+    if(_transcode)
+        _transcoder->putEncoded(data);
+    _jitter_buffer->put(data, _jitter_timer.elapsed());
+}
+
+/// Called from the run loop, decodes at most one frame per frame period
+void RadioOp::playoutAudio()
 {
-    short *audio_out;
-    int samples;
-    if((_rx_mode == gr_modem_types::ModemTypeBPSK2000) ||
-            (_rx_mode == gr_modem_types::ModemType2FSK2000) ||
-            (_rx_mode == gr_modem_types::ModemType4FSK2000) ||
-            (_rx_mode == gr_modem_types::ModemTypeQPSK2000))
+    ByteFrame frame;
+    int status = _jitter_buffer->get(frame, _jitter_timer.elapsed());
+    if(status == JitterBuffer::FrameWaiting)
+        return;
+    short audio_out[AudioEncoder::MaxFrameSamples];
+    int samples = 0;
+    float fade_start = 1.0f;
+    float fade_end = 1.0f;
+    const gr_modem_types::modem_info *modem = gr_modem_types::get_modem_info(_rx_mode);
+    bool codec2 = modem && (modem->codec == gr_modem_types::CodecCodec2);
+    if(status == JitterBuffer::FrameReady)
+    {
+        if(codec2)
+            samples = _codec->decode_codec2(frame.constData(), frame.size(), audio_out,
+                                            _modem->codec2Mode(_rx_mode));
+        else
+            samples = _codec->decode_opus(frame.constData(), frame.size(), audio_out);
+        _last_voice_frame = frame;
+    }
+    else if(codec2)
     {
-        audio_out = _codec->decode_codec2(data, size, samples);
+        // Codec2 has no concealment of its own, repeat the last frame while fading it out
+        if(_last_voice_frame.isNull())
+            return;
+        samples = _codec->decode_codec2(_last_voice_frame.constData(), _last_voice_frame.size(),
+                                        audio_out, _modem->codec2Mode(_rx_mode));
+        float steps = (float)_jitter_buffer->maxConcealed();
+        fade_start = 1.0f - (_jitter_buffer->concealedFrames() - 1) / steps;
+        fade_end = 1.0f - _jitter_buffer->concealedFrames() / steps;
+    }
+    else if(_codec->get_opus_profile().fec && _jitter_buffer->peek(frame))
+    {
+        samples = _codec->decode_opus_fec(frame.constData(), frame.size(), audio_out);
     }
-    else if((_rx_mode == gr_modem_types::ModemTypeBPSK1000))
-        audio_out = _codec->decode_codec2_700(data, size, samples);
     else
-        audio_out = _codec->decode_opus(data, size, samples);
-    delete[] data;
+    {
+        samples = _codec->decode_opus(NULL, 0, audio_out);
+    }
     if(samples > 0)
     {
         for(int i=0;i<samples;i++)
         {
-            audio_out[i] = (short)((float)audio_out[i] * _rx_volume);
+            float fade = fade_start + (fade_end - fade_start) * i / samples;
+            audio_out[i] = (short)((float)audio_out[i] * _rx_volume * fade);
         }
         if(_voip_forwarding)
         {
-            emit voipData(audio_out,samples*sizeof(short));
+            emit voipData(PcmFrame(audio_out,samples));
         }
         else
         {
@@ -554,19 +654,22 @@ void RadioOp::receiveAudioData(unsigned char *data, int size)
     }
 }
 
-void RadioOp::receivePCMAudio(std::vector<float> *audio_data)
+void RadioOp::receivePCMAudio(FloatFrame audio_data)
 {
-    int size = audio_data->size();
+    int size = audio_data.size();
     if(size > 4096)
     {
-        delete audio_data;
         return;
     }
+    if(_transcode)
+        _transcoder->putAudio(audio_data);
 
-    short *pcm = new short[size];
+    PcmFrame pcm_frame(size);
+    short *pcm = pcm_frame.data();
+    const float *in = audio_data.constData();
     for(int i=0;i<size;i++)
     {
-        pcm[i] = (short)(audio_data->at(i) *_rx_volume * 32767.0f);
+        pcm[i] = (short)(in[i] *_rx_volume * 32767.0f);
     }
     if(_voip_forwarding)
     {
@@ -574,18 +677,15 @@ void RadioOp::receivePCMAudio(std::vector<float> *audio_data)
         {
             _voip_encode_buffer->push_back(pcm[i]);
         }
-        delete[] pcm;
     }
     else
     {
         _audio->write_short(pcm, size*sizeof(short));
     }
-    audio_data->clear();
-    delete audio_data;
     audioFrameReceived();
 }
 
-int RadioOp::getFrameLength(unsigned char *data)
+int RadioOp::getFrameLength(const unsigned char *data)
 {
     unsigned long frame_size1;
     unsigned long frame_size2;
@@ -604,20 +704,15 @@ int RadioOp::getFrameLength(unsigned char *data)
         return 0;
 }
 
-void RadioOp::receiveVideoData(unsigned char *data, int size)
+void RadioOp::receiveVideoData(ByteFrame data)
 {
-    int frame_size = getFrameLength(data);
-    if(frame_size == 0)
+    int frame_size = getFrameLength(data.constData());
+    if((frame_size == 0) || (frame_size > data.size() - 12))
     {
         qDebug() << "received corrupted frame size, dropping frame ";
-        delete[] data;
         return;
     }
-    unsigned char *jpeg_frame = new unsigned char[frame_size];
-    memcpy(jpeg_frame, &data[12], frame_size);
-    delete[] data;
-    unsigned char *raw_output = _video->decode_jpeg(jpeg_frame,frame_size);
-    delete[] jpeg_frame;
+    unsigned char *raw_output = _video->decode_jpeg(&(data.data()[12]),frame_size);
     if(!raw_output)
     {
 
@@ -633,72 +728,78 @@ void RadioOp::receiveVideoData(unsigned char *data, int size)
 
 }
 
-void RadioOp::receiveNetData(unsigned char *data, int size)
+void RadioOp::receiveNetData(ByteFrame data)
 {
-    int frame_size = getFrameLength(data);
-    if(frame_size == 0)
+    int frame_size = getFrameLength(data.constData());
+    if((frame_size == 0) || (frame_size > data.size() - 12))
     {
         qDebug() << "received corrupted frame size, dropping frame ";
-        delete[] data;
         return;
     }
-    unsigned char *net_frame = new unsigned char[frame_size];
-    memcpy(net_frame, &data[12], frame_size);
-    delete[] data;
-    int res = _net_device->write_buffered(net_frame,frame_size);
+    _net_device->write_buffered(&(data.constData()[12]),frame_size);
 }
 
-void RadioOp::processVoipAudioFrame(short *pcm, int samples, quint64 sid)
+void RadioOp::processVoipAudioFrame(PcmFrame audio, quint64 sid)
 {
+    _voip_mixer->put(sid, audio.constData(), audio.size());
+}
 
-    if(_m_queue->empty())
+/// Decoded VOIP audio is taken from the voice thread's queue, set before the thread starts
+void RadioOp::setVoipSource(UDPVoice *voice)
+{
+    _voip_source = voice;
+}
+
+/// Mixes the VOIP speakers on a fixed 20 ms clock, driven from the run loop
+void RadioOp::mixVoipAudio()
+{
+    if(_voip_source)
     {
-        for(int i=0;i<samples;i++)
-        {
-            _m_queue->push_back(pcm[i]);
-        }
+        PcmFrame pcm;
+        quint64 session_id;
+        while(_voip_source->getAudio(pcm, session_id))
+            processVoipAudioFrame(pcm, session_id);
     }
-    else
+    qint64 now = _voip_mix_timer.elapsed();
+    if(_voip_mixer->sessions() < 1)
     {
-        unsigned int size = (_m_queue->size() > samples) ? samples : _m_queue->size();
-        for(unsigned int i=0;i<size;i++)
-        {
-            _m_queue->at(i) = _m_queue->at(i)/2-1 + pcm[i]/2-1;
-        }
-        if(_m_queue->size() < samples)
-        {
-            for(int i=_m_queue->size();i<samples;i++)
-            {
-                _m_queue->push_back(pcm[i]);
-            }
-        }
+        _voip_mix_time = now;
+        return;
     }
-    delete[] pcm;
-    quint64 milisec = (quint64)_last_voiced_frame_timer.nsecsElapsed()/1000000;
-    if((milisec >= 20) || (sid == _last_session_id))
+    // after a stall resume from now instead of bursting out the backlog
+    if(now - _voip_mix_time > 5 * VoipMixer::BlockMs)
+        _voip_mix_time = now - VoipMixer::BlockMs;
+    short mixed[VoipMixer::BlockSamples];
+    while(now - _voip_mix_time >= VoipMixer::BlockMs)
     {
-
-        short *pcm = new short[_m_queue->size()];
-        for(unsigned int i = 0;i<_m_queue->size();i++)
+        _voip_mix_time += VoipMixer::BlockMs;
+        int samples = _voip_mixer->mix(mixed);
+        if(samples <= 0)
+            continue;
+        for(int i = 0;i<samples;i++)
         {
-            pcm[i] = (short)((float)_m_queue->at(i) * _rx_volume);
+            mixed[i] = (short)((float)mixed[i] * _rx_volume);
         }
         if(_voip_forwarding && _tx_inited)
         {
+            // the vocoders take 40 ms blocks
+            memcpy(_voip_tx_block.data() + _voip_tx_samples, mixed, samples*sizeof(short));
+            _voip_tx_samples += samples;
+            if(_voip_tx_samples < _voip_tx_block.size())
+                continue;
+            _voip_tx_samples = 0;
             if(!_voip_tx_timer->isActive())
             {
                 startTx();
             }
             _voip_tx_timer->start(200);
-            txAudio(pcm, samples*sizeof(short));
+            txAudio(PcmFrame(_voip_tx_block.constData(), _voip_tx_block.size()));
         }
         else
         {
-            _audio->write_short(pcm, samples*sizeof(short));
+            _voip_tx_samples = 0;
+            _audio->write_short(mixed, samples*sizeof(short));
         }
-        _last_voiced_frame_timer.restart();
-        _m_queue->clear();
-        _last_session_id = sid;
     }
 }
 
@@ -739,12 +840,14 @@ void RadioOp::audioFrameReceived()
 {
     emit displayReceiveStatus(true);
     _voice_led_timer->start(100);
+    _scanner->signalDetected();
 }
 
 void RadioOp::dataFrameReceived()
 {
     emit displayDataReceiveStatus(true);
     _data_led_timer->start(100);
+    _scanner->signalDetected();
 }
 
 void RadioOp::receiveEnd()
@@ -755,14 +858,14 @@ void RadioOp::receiveEnd()
 
 void RadioOp::endAudioTransmission()
 {
+    _jitter_buffer->endOfStream();
     QString time= QDateTime::currentDateTime().toString("d/MMM/yyyy hh:mm:ss");
     emit printText(time + " <<<< end transmission <<<<\n");
     QFile resfile(":/res/end_beep.raw");
     if(resfile.open(QIODevice::ReadOnly))
     {
-        QByteArray *data = new QByteArray(resfile.readAll());
-        short *samples = (short*) data->data();
-        _audio->write_short(samples,data->size());
+        QByteArray data = resfile.readAll();
+        _audio->write_short((short*) data.data(),data.size());
 
     }
 }
@@ -785,7 +888,8 @@ void RadioOp::toggleRX(bool value)
                                  rx_antenna, tx_antenna, rx_freq_corr,
                                  tx_freq_corr, callsign, video_device);
         _modem->initRX(_rx_mode, rx_device_args, rx_antenna, rx_freq_corr);
-        _fft_gui->set_frequency_range(_tune_center_freq, 1000000);
+        if(_fft_gui)
+            _fft_gui->set_x_axis(_tune_center_freq - 500000, 1000000.0 / 8192);
         _modem->setRxSensitivity(_rx_sensitivity);
         _modem->setSquelch(_squelch);
         _modem->setRxCTCSS(_rx_ctcss);
@@ -800,9 +904,11 @@ void RadioOp::toggleRX(bool value)
     else
     {
 
-        _modem->stopRX();
+        if(!_rx_paused)
+            _modem->stopRX();
         _modem->deinitRX(_rx_mode);
         _rx_inited = false;
+        _rx_paused = false;
     }
 }
 
@@ -824,8 +930,21 @@ void RadioOp::toggleTX(bool value)
 
         _modem->initTX(_tx_mode, tx_device_args, tx_antenna, tx_freq_corr);
         _modem->setTxPower(_tx_power);
-        _modem->tuneTx(50000000);
         _modem->setTxCTCSS(_tx_ctcss);
+        if(_settings->_full_duplex && (tx_device_args == rx_device_args))
+            qDebug() << "Full duplex needs separate RX and TX devices";
+        // full duplex and burst devices run until TX is disabled and PTT
+        // only keys the gate. A half duplex device without bursts would
+        // send zeros between transmissions and block RX on a shared
+        // device, so its flowgraph only runs while keyed
+        _modem->setTxGate(false);
+        _tx_streaming = _settings->_full_duplex || _modem->txBurstMode();
+        if(_settings->_full_duplex)
+            _modem->tuneTx(_tune_center_freq + _tune_shift_freq);
+        else
+            _modem->tuneTx(50000000);
+        if(_tx_streaming)
+            _modem->startTX();
         if(_tx_mode == gr_modem_types::ModemTypeQPSKVideo)
             _video = new VideoEncoder(QString::fromStdString(video_device));
         if(_tx_mode == gr_modem_types::ModemTypeQPSK250000 && _net_device == 0)
@@ -836,7 +955,11 @@ void RadioOp::toggleTX(bool value)
     }
     else
     {
+        _tx_closing = false;
         _modem->deinitTX(_tx_mode);
+        if(_rx_paused && _rx_inited)
+            _modem->startRX();
+        _rx_paused = false;
         if(_tx_mode == gr_modem_types::ModemTypeQPSKVideo)
         {
             delete _video;
@@ -955,6 +1078,14 @@ void RadioOp::toggleRxMode(int value)
         break;
     }
 
+    const gr_modem_types::modem_info *rx_modem = gr_modem_types::get_modem_info(_rx_mode);
+    bool opus_fec = rx_modem && (rx_modem->codec == gr_modem_types::CodecOpus)
+            && _codec->get_opus_profile().fec;
+    _jitter_buffer->setBurstFrames(_modem->voiceFrames(_rx_mode));
+    // one frame of lookahead lets a lost Opus frame be rebuilt from the next one
+    _jitter_buffer->setMinDepth(opus_fec ? 2 : 1);
+    _jitter_buffer->reset();
+    _last_voice_frame.clear();
     _modem->toggleRxMode(_rx_mode);
     if(rx_inited_before)
     {
@@ -1082,20 +1213,58 @@ void RadioOp::setVOIPForwarding(bool value)
 void RadioOp::toggleRepeat(bool value)
 {
 
-    if((_rx_mode != _tx_mode) && value) // no mixed mode repeat
-        return;
     if(value && !_repeat)
     {
         _repeat = value;
+        _transcode = needsTranscoding();
+        if(_transcode)
+            _transcoder->setModes(_rx_mode, _modem->codec2Mode(_rx_mode),
+                                  _tx_mode, _modem->codec2Mode(_tx_mode));
         startTx();
     }
     else if(!value && _repeat)
     {
         stopTx();
         _repeat = value;
+        _transcode = false;
     }
-    _modem->setRepeater(value);
+    // the modem relays frames itself unless the voice has to be transcoded
+    _modem->setRepeater(_repeat && !_transcode);
+
+}
+
+/**
+ * Analog modes repeat the demodulated audio directly and digital modes with
+ * the same vocoder only need new framing, everything else goes through
+ * the transcoder.
+ */
+bool RadioOp::needsTranscoding()
+{
+    if((_rx_radio_type == radio_type::RADIO_TYPE_ANALOG)
+            && (_tx_radio_type == radio_type::RADIO_TYPE_ANALOG))
+        return false;
+    if((_rx_radio_type == radio_type::RADIO_TYPE_ANALOG)
+            || (_tx_radio_type == radio_type::RADIO_TYPE_ANALOG))
+        return true;
+    const gr_modem_types::modem_info *rx = gr_modem_types::get_modem_info(_rx_mode);
+    const gr_modem_types::modem_info *tx = gr_modem_types::get_modem_info(_tx_mode);
+    if(!rx || !tx || (rx->codec == gr_modem_types::CodecNone) || (tx->codec == gr_modem_types::CodecNone))
+        return false;
+    if(rx->codec != tx->codec)
+        return true;
+    return (rx->codec == gr_modem_types::CodecCodec2)
+            && (_modem->codec2Mode(_rx_mode) != _modem->codec2Mode(_tx_mode));
+}
 
+/// Hands the transcoded voice to the modulator, called from the run loop
+void RadioOp::transcodedAudio()
+{
+    ByteFrame frame;
+    while(_transcoder->getEncoded(frame))
+        emit audioData(frame);
+    FloatFrame audio;
+    while(_transcoder->getAudio(audio))
+        emit pcmData(audio);
 }
 
 void RadioOp::fineTuneFreq(long center_freq)
@@ -1113,7 +1282,44 @@ void RadioOp::tuneFreq(qint64 center_freq)
     _modem->tune(_tune_center_freq);
     //_modem->tuneTx(_tune_center_freq + _tune_shift_freq);
     _mutex->unlock();
-    _fft_gui->set_frequency_range(_tune_center_freq, 1000000);
+    if(_fft_gui)
+        _fft_gui->set_x_axis(_tune_center_freq - 500000, 1000000.0 / 8192);
+}
+
+void RadioOp::startScan(qint64 start_freq, qint64 stop_freq, int step_hz)
+{
+    _scanner->setRange(start_freq, stop_freq, step_hz);
+    _scanner->setRSSIThreshold((float)_squelch);
+    _scanner->start();
+    qDebug() << "Scanning" << start_freq << "to" << stop_freq << "in" << step_hz << "Hz steps";
+}
+
+void RadioOp::stopScan()
+{
+    if(_scanner->isScanning())
+        qDebug() << "Scan stopped at" << _scanner->channelsPerSecond() << "channels/s";
+    _scanner->stop();
+    _mutex->lock();
+    _modem->tune(_tune_center_freq);
+    _mutex->unlock();
+}
+
+void RadioOp::scanChannelFound(qint64 freq)
+{
+    qDebug() << "Scanner stopped on" << freq << "after"
+             << _scanner->channelsPerSecond() << "channels/s";
+    _mutex->lock();
+    _tune_center_freq = freq;
+    _modem->tuneTx(_tune_center_freq + _tune_shift_freq);
+    _mutex->unlock();
+    if(_fft_gui)
+        _fft_gui->set_x_axis(_tune_center_freq - 500000, 1000000.0 / 8192);
+    emit freqFromGUI(_tune_center_freq);
+}
+
+void RadioOp::scanResumed()
+{
+    qDebug() << "Scanning resumed," << _scanner->channelsPerSecond() << "channels/s";
 }
 
 void RadioOp::tuneTxFreq(qint64 center_freq)
@@ -1182,30 +1388,41 @@ void RadioOp::syncFrequency()
         return;
     }
     _tune_counter = _modem->_frequency_found;
-    autoTune();
+    if(_tuning_done)
+        startAutoTune();
 
 }
 
 void RadioOp::autoTune()
 {
-    if((_rx_mode == gr_modem_types::ModemTypeBPSK2000)
-            || (_rx_mode == gr_modem_types::ModemTypeBPSK1000))
-        usleep(500);
-    else if ((_rx_mode == gr_modem_types::ModemType4FSK2000) ||
-             (_rx_mode == gr_modem_types::ModemType2FSK2000) ||
-             (_rx_mode == gr_modem_types::ModemTypeQPSK2000))
-        usleep(2000);
-    else
-        usleep(10);
-    _tune_center_freq = _tune_center_freq + _step_hz;
+    float offset = 0;
+    int result = _modem->getCarrierOffset(offset);
+    if(result < 0)
+        return; // acquisition burst still running
+    if(result == 0)
+    {
+        // nothing above the noise floor yet, listen for another burst
+        _modem->startCarrierEstimate();
+        return;
+    }
+    long long shift = (long long)offset;
+    if(shift < _tune_limit_lower)
+        shift = _tune_limit_lower;
+    if(shift > _tune_limit_upper)
+        shift = _tune_limit_upper;
+    _mutex->lock();
+    _tune_center_freq = _tune_center_freq + shift;
     _modem->tune(_tune_center_freq);
     _modem->tuneTx(_tune_center_freq + _tune_shift_freq);
-    if(_tune_center_freq >= (_tune_center_freq + _tune_limit_upper))
-        _tune_center_freq = _tune_center_freq + _tune_limit_lower;
+    _mutex->unlock();
+    emit freqFromGUI(_tune_center_freq);
+    // the band edge FLL in the demodulator takes over fine tracking
+    _tuning_done = true;
 }
 
 void RadioOp::startAutoTune()
 {
+    _modem->startCarrierEstimate();
     _tuning_done = false;
 }
 
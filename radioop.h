@@ -20,6 +20,7 @@
 #include <QObject>
 #include <QDateTime>
 #include <QTimer>
+#include <QThread>
 #include <QMutex>
 #include <QDir>
 #include <QFileInfo>
@@ -35,14 +36,20 @@
 #include "audio/audiointerface.h"
 #include "ext/agc.h"
 #include "ext/vox.h"
+#include "ext/framebuffer.h"
 #include "settings.h"
 #include "audio/audioencoder.h"
+#include "audio/voipmixer.h"
+#include "audio/transcoder.h"
+#include "udpvoice.h"
+#include "audio/jitterbuffer.h"
 #include "video/videoencoder.h"
 #include "audio/alsaaudio.h"
 #include "gr/gr_modem.h"
 #include "net/netdevice.h"
+#include "scanner.h"
 #include <gnuradio/qtgui/const_sink_c.h>
-#include <gnuradio/qtgui/sink_c.h>
+#include <gnuradio/qtgui/vector_sink_f.h>
 #include <gnuradio/qtgui/number_sink.h>
 #include <libconfig.h++>
 
@@ -60,7 +67,7 @@ class RadioOp : public QObject
 {
     Q_OBJECT
 public:
-    explicit RadioOp(Settings *settings, gr::qtgui::sink_c::sptr fft_gui,
+    explicit RadioOp(Settings *settings, gr::qtgui::vector_sink_f::sptr fft_gui,
                      gr::qtgui::const_sink_c::sptr const_gui, gr::qtgui::number_sink::sptr rssi_gui, QObject *parent = 0);
     ~RadioOp();
 
@@ -68,6 +75,7 @@ public:
     int processVideoStream(bool &frame_flag);
     void processNetStream();
     void sendEndBeep();
+    void setGatewayChannel(const GatewayChannel &channel);
 
 signals:
     void finished();
@@ -76,16 +84,16 @@ signals:
     void displayReceiveStatus(bool status);
     void displayTransmitStatus(bool status);
     void displayDataReceiveStatus(bool status);
-    void audioData(unsigned char *buf, int size);
-    void pcmData(std::vector<float> *pcm);
-    void videoData(unsigned char *buf, int size);
-    void netData(unsigned char *buf, int size);
+    void audioData(ByteFrame buf);
+    void pcmData(FloatFrame pcm);
+    void videoData(ByteFrame buf);
+    void netData(ByteFrame buf);
     void videoImage(QImage img);
     void endAudio(int secs);
     void startAudio();
     void freqFromGUI(long freq);
     void pingServer();
-    void voipData(short *pcm, int samples);
+    void voipData(PcmFrame pcm);
 public slots:
     void run();
     void startTransmission();
@@ -97,10 +105,10 @@ public slots:
     void audioFrameReceived();
     void dataFrameReceived();
     void receiveEnd();
-    void receiveAudioData(unsigned char *data, int size);
-    void receiveVideoData(unsigned char *data, int size);
-    void receiveNetData(unsigned char *data, int size);
-    void receivePCMAudio(std::vector<float>* audio_data);
+    void receiveAudioData(ByteFrame data);
+    void receiveVideoData(ByteFrame data);
+    void receiveNetData(ByteFrame data);
+    void receivePCMAudio(FloatFrame audio_data);
     void toggleRX(bool value);
     void toggleTX(bool value);
     void toggleRxMode(int value);
@@ -121,13 +129,18 @@ public slots:
     void startAutoTune();
     void stopAutoTune();
     void endAudioTransmission();
-    void processVoipAudioFrame(short *pcm, int samples, quint64 sid);
+    void processVoipAudioFrame(PcmFrame pcm, quint64 sid);
+    void setVoipSource(UDPVoice *voice);
     void usePTTForVOIP(bool value);
     void setVOIPForwarding(bool value);
     void startTx();
     void stopTx();
     void updateFrequency();
     void toggleRepeat(bool value);
+    void startScan(qint64 start_freq, qint64 stop_freq, int step_hz);
+    void stopScan();
+    void scanChannelFound(qint64 freq);
+    void scanResumed();
 
 private:
     bool _stop;
@@ -152,6 +165,7 @@ private:
     VideoEncoder *_video;
     NetDevice *_net_device;
     gr_modem *_modem;
+    Scanner *_scanner;
     int _rx_mode;
     int _tx_mode;
     int _rx_radio_type;
@@ -165,26 +179,44 @@ private:
     int _tune_limit_lower;
     int _tune_limit_upper;
     bool _tuning_done;
-    bool _tx_modem_started;
     int _tune_counter;
     float _rx_ctcss;
     float _tx_ctcss;
     float _rx_volume;
-    QElapsedTimer _last_voiced_frame_timer;
+    JitterBuffer *_jitter_buffer;
+    QElapsedTimer _jitter_timer;
+    ByteFrame _last_voice_frame;
     QTimer *_voip_tx_timer;
-    gr::qtgui::sink_c::sptr _fft_gui;
+    gr::qtgui::vector_sink_f::sptr _fft_gui;
+    bool _gateway;
+    GatewayChannel _gateway_channel;
     unsigned char *_rand_frame_data;
-    std::vector<short> *_m_queue;
-    quint64 _last_session_id;
+    VoipMixer *_voip_mixer;
+    UDPVoice *_voip_source;
+    QElapsedTimer _voip_mix_timer;
+    qint64 _voip_mix_time;
+    PcmFrame _voip_tx_block;
+    int _voip_tx_samples;
     QVector<short> *_voip_encode_buffer;
     bool _repeat;
+    bool _transcode;
+    bool _tx_closing;
+    bool _tx_streaming;
+    bool _rx_paused;
+    Transcoder *_transcoder;
+    QThread *_transcoder_thread;
 
     void readConfig(std::string &rx_device_args, std::string &tx_device_args,
                     std::string &rx_antenna, std::string &tx_antenna, int &rx_freq_corr,
                     int &tx_freq_corr, std::string &callsign, std::string &video_device);
-    int getFrameLength(unsigned char *data);
-    void txAudio(short *audiobuffer, int audiobuffer_size);
-    void vox(short *audiobuffer, int audiobuffer_size);
+    int getFrameLength(const unsigned char *data);
+    void txAudio(PcmFrame audiobuffer);
+    void playoutAudio();
+    void mixVoipAudio();
+    bool needsTranscoding();
+    void transcodedAudio();
+    void finishTx();
+    void vox(const short *audiobuffer, int audiobuffer_size);
 
 };
 
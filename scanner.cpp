@@ -0,0 +1,193 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "scanner.h"
+
+Scanner::Scanner(gr_modem *modem, int samp_rate, QObject *parent) :
+    QObject(parent)
+{
+    _modem = modem;
+    _samp_rate = samp_rate;
+    // the demodulator carrier offset can be up to 250 kHz, so only the
+    // central part of the capture is free of aliases on both sides
+    _usable_span = 400000;
+    _channel_width = 12500;
+    _hang_time = 3000;
+    _threshold = 10.0;
+    _rssi_threshold = -80.0;
+    _state = ScanStateIdle;
+    _next_channel = 0;
+    _window_first = 0;
+    _window_last = -1;
+    _window_center = 0;
+    _channels_scanned = 0;
+}
+
+void Scanner::setChannels(QVector<qint64> channels, int channel_width)
+{
+    _channels = channels;
+    std::sort(_channels.begin(), _channels.end());
+    _channel_width = channel_width;
+    _next_channel = 0;
+}
+
+void Scanner::setRange(qint64 start_freq, qint64 stop_freq, int step_hz)
+{
+    QVector<qint64> channels;
+    if(step_hz < 1)
+        return;
+    for(qint64 freq = start_freq; freq <= stop_freq; freq += step_hz)
+        channels.append(freq);
+    setChannels(channels, step_hz);
+}
+
+void Scanner::setThreshold(float db_above_noise)
+{
+    _threshold = db_above_noise;
+}
+
+void Scanner::setRSSIThreshold(float rssi)
+{
+    _rssi_threshold = rssi;
+}
+
+void Scanner::setHangTime(int msec)
+{
+    _hang_time = msec;
+}
+
+void Scanner::start()
+{
+    if(_channels.size() < 1)
+    {
+        qDebug() << "Scanner: no channels to scan";
+        return;
+    }
+    _channels_scanned = 0;
+    _rate_timer.start();
+    _modem->enableSpectrumAnalysis(true);
+    tuneNextWindow();
+}
+
+void Scanner::stop()
+{
+    if(_state != ScanStateIdle)
+        _modem->enableSpectrumAnalysis(false);
+    _state = ScanStateIdle;
+}
+
+bool Scanner::isScanning()
+{
+    return _state != ScanStateIdle;
+}
+
+float Scanner::channelsPerSecond()
+{
+    if(!_rate_timer.isValid() || _rate_timer.elapsed() < 1)
+        return 0;
+    return (float)_channels_scanned * 1000.0 / (float)_rate_timer.elapsed();
+}
+
+void Scanner::signalDetected()
+{
+    if(_state == ScanStateDwell)
+        _hang_timer.restart();
+}
+
+void Scanner::tuneNextWindow()
+{
+    if(_next_channel >= _channels.size())
+        _next_channel = 0;
+    _window_first = _next_channel;
+    _window_last = _next_channel;
+    qint64 limit = _channels[_window_first] + _usable_span - _channel_width;
+    while((_window_last + 1 < _channels.size()) && (_channels[_window_last + 1] <= limit))
+        _window_last++;
+    _window_center = (_channels[_window_first] + _channels[_window_last]) / 2;
+    _modem->tune(_window_center);
+    _state = ScanStateSettle;
+}
+
+int Scanner::evaluateWindow(const std::vector<float> &frame)
+{
+    int fft_size = frame.size();
+    float bin_hz = (float)_samp_rate / (float)fft_size;
+    std::vector<float> sorted = frame;
+    std::nth_element(sorted.begin(), sorted.begin() + fft_size / 2, sorted.end());
+    float noise_floor = sorted[fft_size / 2];
+
+    int best = -1;
+    float best_level = noise_floor + _threshold;
+    int half_width = std::max(1, (int)(0.4 * _channel_width / bin_hz));
+    for(int i=_window_first;i<=_window_last;i++)
+    {
+        int center = fft_size / 2 + (int)((_channels[i] - _window_center) / bin_hz);
+        int low = std::max(0, center - half_width);
+        int high = std::min(fft_size - 1, center + half_width);
+        float power = 0;
+        for(int j=low;j<=high;j++)
+            power += powf(10.0, frame[j] / 10.0);
+        float level = 10.0 * log10f(power / (float)(high - low + 1) + 1e-20);
+        if(level > best_level)
+        {
+            best_level = level;
+            best = i;
+        }
+    }
+    _channels_scanned += _window_last - _window_first + 1;
+    return best;
+}
+
+void Scanner::process()
+{
+    switch(_state)
+    {
+    case ScanStateSettle:
+    {
+        // the engine drops the frame captured across the retune, so the
+        // first counted frame is unaveraged and only holds the new window
+        if(_modem->getSpectrumFrames() < 1)
+            return;
+        std::vector<float> frame;
+        if(!_modem->getSpectrum(frame))
+            return;
+        int found = evaluateWindow(frame);
+        if(found < 0)
+        {
+            _next_channel = _window_last + 1;
+            tuneNextWindow();
+            return;
+        }
+        _modem->tune(_channels[found]);
+        _next_channel = found + 1;
+        _hang_timer.start();
+        _state = ScanStateDwell;
+        emit channelFound(_channels[found]);
+        break;
+    }
+    case ScanStateDwell:
+        if(_modem->getRSSI() > _rssi_threshold)
+            _hang_timer.restart();
+        if(_hang_timer.elapsed() > _hang_time)
+        {
+            tuneNextWindow();
+            emit scanResumed();
+        }
+        break;
+    default:
+        break;
+    }
+}
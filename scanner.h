@@ -0,0 +1,89 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef SCANNER_H
+#define SCANNER_H
+
+#include <QObject>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include "gr/gr_modem.h"
+
+/**
+ * @brief Sweeps a list of channels using the spectrum frames of the
+ * wideband capture.
+ *
+ * Every retune covers all channels that fit inside the usable part of the
+ * capture, so a sweep costs one settle time per window instead of one per
+ * channel. When a channel rises above the noise floor the receiver is parked
+ * on it and stays there while RSSI or received frames show activity, then
+ * scanning resumes after the hang time.
+ */
+class Scanner : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Scanner(gr_modem *modem, int samp_rate=1000000, QObject *parent = 0);
+
+    void setChannels(QVector<qint64> channels, int channel_width);
+    void setRange(qint64 start_freq, qint64 stop_freq, int step_hz);
+    void setThreshold(float db_above_noise);
+    void setRSSIThreshold(float rssi);
+    void setHangTime(int msec);
+    void start();
+    void stop();
+    bool isScanning();
+    void process();
+    void signalDetected();
+    float channelsPerSecond();
+
+signals:
+    void channelFound(qint64 freq);
+    void scanResumed();
+
+private:
+    enum
+    {
+        ScanStateIdle,
+        ScanStateSettle,
+        ScanStateDwell
+    };
+    void tuneNextWindow();
+    int evaluateWindow(const std::vector<float> &frame);
+
+    gr_modem *_modem;
+    QVector<qint64> _channels;
+    QElapsedTimer _hang_timer;
+    QElapsedTimer _rate_timer;
+    int _state;
+    int _samp_rate;
+    int _usable_span;
+    int _channel_width;
+    int _hang_time;
+    float _threshold;
+    float _rssi_threshold;
+    int _next_channel;
+    int _window_first;
+    int _window_last;
+    qint64 _window_center;
+    quint64 _channels_scanned;
+};
+
+#endif // SCANNER_H
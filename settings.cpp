@@ -17,6 +17,25 @@ Settings::Settings()
     _enable_agc = 0; // unused
     _ident_time = 300; // used
     _radio_id = "";
+    _spectrum_frame_rate = 10; // used
+    _spectrum_averaging = 4; // used
+    _scan_hang_time = 3000; // used
+    _scan_threshold = 10.0; // used
+    _scan_start_freq = 0; // used, 0 scans 1 MHz around the current frequency
+    _scan_stop_freq = 0; // used
+    _scan_step = 12500; // used
+    _cache_filter_taps = 1; // used
+    _codec2_superframe = 1; // used
+    _codec2_best_mode = 0; // used
+    _opus_profile = 0; // used
+    _opus_bitrate = -1; // used, negative keeps the profile value
+    _opus_complexity = -1; // used
+    _opus_packet_loss = -1; // used
+    _mumble_frames_per_packet = 1; // used, 40 ms voice blocks
+    _mumble_tcp_write_delay = 5; // used, milliseconds, 0 disables coalescing
+    _repeater_hold_time = 40; // used, milliseconds between reception and retransmission
+    _full_duplex = 0; // used, RX and TX on separate devices, TX flowgraph always running
+    _gateway_mode = 0; // used, headless, one radio per _gateway_channels entry
 
     voip_server="127.0.0.1";
     _config_file = setupConfig();
@@ -67,6 +86,67 @@ void Settings::readConfig()
 
         cfg.lookupValue("rx_freq_corr", rx_freq_corr);
         cfg.lookupValue("tx_freq_corr", tx_freq_corr);
+        cfg.lookupValue("spectrum_frame_rate", _spectrum_frame_rate);
+        cfg.lookupValue("spectrum_averaging", _spectrum_averaging);
+        cfg.lookupValue("scan_hang_time", _scan_hang_time);
+        cfg.lookupValue("scan_threshold", _scan_threshold);
+        cfg.lookupValue("scan_start_freq", _scan_start_freq);
+        cfg.lookupValue("scan_stop_freq", _scan_stop_freq);
+        cfg.lookupValue("scan_step", _scan_step);
+        int cache_filter_taps = _cache_filter_taps;
+        if(cfg.lookupValue("cache_filter_taps", cache_filter_taps))
+            _cache_filter_taps = cache_filter_taps;
+        cfg.lookupValue("codec2_superframe", _codec2_superframe);
+        int codec2_best_mode = _codec2_best_mode;
+        if(cfg.lookupValue("codec2_best_mode", codec2_best_mode))
+            _codec2_best_mode = codec2_best_mode;
+        cfg.lookupValue("opus_profile", _opus_profile);
+        cfg.lookupValue("opus_bitrate", _opus_bitrate);
+        cfg.lookupValue("opus_complexity", _opus_complexity);
+        cfg.lookupValue("opus_packet_loss", _opus_packet_loss);
+        cfg.lookupValue("mumble_frames_per_packet", _mumble_frames_per_packet);
+        cfg.lookupValue("mumble_tcp_write_delay", _mumble_tcp_write_delay);
+        cfg.lookupValue("repeater_hold_time", _repeater_hold_time);
+        int full_duplex = _full_duplex;
+        if(cfg.lookupValue("full_duplex", full_duplex))
+            _full_duplex = full_duplex;
+        int gateway_mode = _gateway_mode;
+        if(cfg.lookupValue("gateway_mode", gateway_mode))
+            _gateway_mode = gateway_mode;
+        _gateway_channels.clear();
+        if(cfg.exists("gateway_channels"))
+        {
+            const libconfig::Setting &channels = cfg.lookup("gateway_channels");
+            for(int i=0;i<channels.getLength();i++)
+            {
+                const libconfig::Setting &c = channels[i];
+                GatewayChannel channel;
+                std::string value;
+                channel.rx_device_args = c.lookupValue("rx_device_args", value) ?
+                            QString::fromStdString(value) : QString("rtl=%1").arg(i);
+                channel.tx_device_args = c.lookupValue("tx_device_args", value) ?
+                            QString::fromStdString(value) : QString("");
+                channel.rx_antenna = c.lookupValue("rx_antenna", value) ?
+                            QString::fromStdString(value) : QString("RX2");
+                channel.tx_antenna = c.lookupValue("tx_antenna", value) ?
+                            QString::fromStdString(value) : QString("TX/RX");
+                channel.rx_freq_corr = 0;
+                channel.tx_freq_corr = 0;
+                channel.rx_frequency = 434000000;
+                channel.tx_shift = 0;
+                channel.rx_mode = 0;
+                channel.tx_mode = 0;
+                channel.mumble_channel = 0;
+                c.lookupValue("rx_freq_corr", channel.rx_freq_corr);
+                c.lookupValue("tx_freq_corr", channel.tx_freq_corr);
+                c.lookupValue("rx_frequency", channel.rx_frequency);
+                c.lookupValue("tx_shift", channel.tx_shift);
+                c.lookupValue("rx_mode", channel.rx_mode);
+                c.lookupValue("tx_mode", channel.tx_mode);
+                c.lookupValue("mumble_channel", channel.mumble_channel);
+                _gateway_channels.append(channel);
+            }
+        }
 
         rx_device_args = QString(cfg.lookup("rx_device_args"));
         tx_device_args = QString(cfg.lookup("tx_device_args"));
@@ -123,6 +203,42 @@ void Settings::saveConfig()
     root.add("rx_frequency",libconfig::Setting::TypeInt64) = rx_frequency;
     root.add("tx_shift",libconfig::Setting::TypeInt64) = tx_shift;
     root.add("voip_server",libconfig::Setting::TypeString) = voip_server.toStdString();
+    root.add("spectrum_frame_rate",libconfig::Setting::TypeInt) = _spectrum_frame_rate;
+    root.add("spectrum_averaging",libconfig::Setting::TypeInt) = _spectrum_averaging;
+    root.add("scan_hang_time",libconfig::Setting::TypeInt) = _scan_hang_time;
+    root.add("scan_threshold",libconfig::Setting::TypeFloat) = _scan_threshold;
+    root.add("scan_start_freq",libconfig::Setting::TypeInt64) = _scan_start_freq;
+    root.add("scan_stop_freq",libconfig::Setting::TypeInt64) = _scan_stop_freq;
+    root.add("scan_step",libconfig::Setting::TypeInt) = _scan_step;
+    root.add("cache_filter_taps",libconfig::Setting::TypeInt) = (int)_cache_filter_taps;
+    root.add("codec2_superframe",libconfig::Setting::TypeInt) = _codec2_superframe;
+    root.add("codec2_best_mode",libconfig::Setting::TypeInt) = (int)_codec2_best_mode;
+    root.add("opus_profile",libconfig::Setting::TypeInt) = _opus_profile;
+    root.add("opus_bitrate",libconfig::Setting::TypeInt) = _opus_bitrate;
+    root.add("opus_complexity",libconfig::Setting::TypeInt) = _opus_complexity;
+    root.add("opus_packet_loss",libconfig::Setting::TypeInt) = _opus_packet_loss;
+    root.add("mumble_frames_per_packet",libconfig::Setting::TypeInt) = _mumble_frames_per_packet;
+    root.add("mumble_tcp_write_delay",libconfig::Setting::TypeInt) = _mumble_tcp_write_delay;
+    root.add("repeater_hold_time",libconfig::Setting::TypeInt) = _repeater_hold_time;
+    root.add("full_duplex",libconfig::Setting::TypeInt) = (int)_full_duplex;
+    root.add("gateway_mode",libconfig::Setting::TypeInt) = (int)_gateway_mode;
+    libconfig::Setting &channels = root.add("gateway_channels",libconfig::Setting::TypeList);
+    for(int i=0;i<_gateway_channels.size();i++)
+    {
+        const GatewayChannel &channel = _gateway_channels.at(i);
+        libconfig::Setting &c = channels.add(libconfig::Setting::TypeGroup);
+        c.add("rx_device_args",libconfig::Setting::TypeString) = channel.rx_device_args.toStdString();
+        c.add("tx_device_args",libconfig::Setting::TypeString) = channel.tx_device_args.toStdString();
+        c.add("rx_antenna",libconfig::Setting::TypeString) = channel.rx_antenna.toStdString();
+        c.add("tx_antenna",libconfig::Setting::TypeString) = channel.tx_antenna.toStdString();
+        c.add("rx_freq_corr",libconfig::Setting::TypeInt) = channel.rx_freq_corr;
+        c.add("tx_freq_corr",libconfig::Setting::TypeInt) = channel.tx_freq_corr;
+        c.add("rx_frequency",libconfig::Setting::TypeInt64) = channel.rx_frequency;
+        c.add("tx_shift",libconfig::Setting::TypeInt64) = channel.tx_shift;
+        c.add("rx_mode",libconfig::Setting::TypeInt) = channel.rx_mode;
+        c.add("tx_mode",libconfig::Setting::TypeInt) = channel.tx_mode;
+        c.add("mumble_channel",libconfig::Setting::TypeInt) = channel.mumble_channel;
+    }
     try
     {
         cfg.writeFile(_config_file->absoluteFilePath().toStdString().c_str());
@@ -8,6 +8,23 @@
 #include <QFileInfo>
 #include <libconfig.h++>
 #include <iostream>
+#include <QVector>
+
+/// One radio channel bridged to a Mumble channel in gateway mode
+struct GatewayChannel
+{
+    QString rx_device_args;
+    QString tx_device_args;
+    QString rx_antenna;
+    QString tx_antenna;
+    int rx_freq_corr;
+    int tx_freq_corr;
+    long long rx_frequency;
+    long long tx_shift;
+    int rx_mode; // same numbering as the modem mode selector
+    int tx_mode;
+    int mumble_channel;
+};
 
 class Settings
 {
@@ -47,6 +64,26 @@ public:
     quint8 _enable_agc;
     quint16 _ident_time;
     QString _radio_id;
+    int _spectrum_frame_rate;
+    int _spectrum_averaging;
+    int _scan_hang_time;
+    float _scan_threshold;
+    long long _scan_start_freq;
+    long long _scan_stop_freq;
+    int _scan_step;
+    quint8 _cache_filter_taps;
+    int _codec2_superframe;
+    quint8 _codec2_best_mode;
+    int _opus_profile;
+    int _opus_bitrate;
+    int _opus_complexity;
+    int _opus_packet_loss;
+    int _mumble_frames_per_packet;
+    int _mumble_tcp_write_delay;
+    int _repeater_hold_time;
+    quint8 _full_duplex;
+    quint8 _gateway_mode;
+    QVector<GatewayChannel> _gateway_channels;
 
 private:
     QFileInfo *_config_file;
@@ -25,6 +25,14 @@ SSLClient::SSLClient(QObject *parent) :
     _connection_tries=0;
     _status=0;
     _reconnect = false;
+    _read_offset = 0;
+    // keeps the storage when the buffer is emptied
+    _read_buffer.reserve(4096);
+    _write_buffer.reserve(MaxRecordSize);
+    _max_write_delay = 0;
+    _write_timer = new QTimer(this);
+    _write_timer->setSingleShot(true);
+    QObject::connect(_write_timer,SIGNAL(timeout()),this,SLOT(flushWrites()));
     _hostname = "127.0.0.1";
     _port= MUMBLE_PORT;
     QSslSocket::addDefaultCaCertificates(QSslSocket::systemCaCertificates());
@@ -53,15 +61,6 @@ SSLClient::SSLClient(QObject *parent) :
     QObject::connect(_socket,SIGNAL(encrypted()),this,SLOT(connectionSuccess()));
     QObject::connect(_socket,SIGNAL(readyRead()),this,SLOT(processData()));
 
-    _udp_socket = new QUdpSocket;
-
-#if QT_VERSION >= QT_VERSION_CHECK(5, 0, 0)
-    _udp_socket->bind(QHostAddress(QHostAddress::AnyIPv4),UDP_PORT);
-#else
-    _udp_socket->bind(QHostAddress(QHostAddress::Any),UDP_PORT);
-#endif
-    QObject::connect(_udp_socket, SIGNAL(readyRead()), this, SLOT(readPendingDatagrams()));
-
 }
 
 
@@ -81,6 +80,9 @@ int SSLClient::connectionStatus()
 void SSLClient::connectionSuccess()
 {
     std::cout << "Successfull server connection" << std::endl;
+    // coalescing is done here, Nagle would only add delay on top
+    _socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    _socket->setSocketOption(QAbstractSocket::KeepAliveOption, 1);
     _status=1;
     _connection_tries=0;
     _reconnect = true;
@@ -151,6 +153,10 @@ void SSLClient::connectHost(const QString &host, const unsigned &port)
         _socket->close();
         _status=0;
     }
+    _read_buffer.resize(0);
+    _read_offset = 0;
+    _write_timer->stop();
+    _write_buffer.resize(0);
     std::cout << "trying " << host.toStdString() << std::endl;
     _socket->connectToHostEncrypted(host, port);
     _hostname = host;
@@ -162,6 +168,7 @@ void SSLClient::disconnectHost()
 {
     if(_status==0)
         return;
+    flushWrites();
     _socket->disconnectFromHost();
     _reconnect = false;
     _status=0;
@@ -171,82 +178,85 @@ void SSLClient::disconnectHost()
 
 
 
+/// Messages written within the delay share one TLS record and one syscall, 0 writes each at once
+void SSLClient::setMaxWriteDelay(int ms)
+{
+    _max_write_delay = ms;
+}
+
 void SSLClient::sendBin(quint8 *payload, quint64 size)
 {
 
     char *message = reinterpret_cast<char*>(payload);
-    _socket->write(message,size);
+    if(_max_write_delay <= 0)
+    {
+        _socket->write(message,size);
+        _socket->flush();
+        return;
+    }
+    _write_buffer.append(message,size);
+    if(_write_buffer.size() >= MaxRecordSize)
+    {
+        flushWrites();
+        return;
+    }
+    if(!_write_timer->isActive())
+        _write_timer->start(_max_write_delay);
+}
+
+void SSLClient::flushWrites()
+{
+    _write_timer->stop();
+    if(_write_buffer.isEmpty())
+        return;
+    _socket->write(_write_buffer);
     _socket->flush();
+    _write_buffer.resize(0);
 }
 
+/**
+ * TCP delivers a byte stream, so one read may hold several messages or
+ * only part of one. Every complete message is emitted straight from the
+ * receive buffer, the tail is kept until the rest of it arrives.
+ * Receivers are connected directly and must not keep the data after
+ * returning, it points into the buffer.
+ */
 void SSLClient::processData()
 {
     //qDebug() << "Received message from " << _socket->peerAddress().toString();
     if (_status !=1) return;
 
-    QByteArray buf;
-    buf.append(_socket->readAll());
-
-    bool endOfLine = false;
-
-    while ((!endOfLine))
+    _read_buffer.append(_socket->readAll());
+    while((_read_buffer.size() - _read_offset) >= PreambleSize)
     {
-        if(_status==1)
+        const quint8 *data = reinterpret_cast<const quint8*>(_read_buffer.constData()) + _read_offset;
+        int type, len;
+        getPreamble(data, &type, &len);
+        if((len < 0) || (len > MaxMessageSize))
         {
-            char ch;
-            if(_socket->bytesAvailable()>0)
-            {
-                int bytesRead = _socket->read(&ch, sizeof(ch));
-                if (bytesRead == sizeof(ch))
-                {
-                    //cnt++;
-                    buf.append( ch );
-                    if(_socket->bytesAvailable()==0)
-                    {
-                        endOfLine = true;
-                    }
-                }
-            }
-            else
-            {
-                break;
-            }
+            std::cerr << "Invalid message length " << len << ", resetting connection" << std::endl;
+            _read_buffer.resize(0);
+            _read_offset = 0;
+            _socket->abort();
+            return;
         }
-        else
-        {
+        int message_size = PreambleSize + len;
+        if((_read_buffer.size() - _read_offset) < message_size)
             break;
-        }
-
+        _read_offset += message_size;
+        emit haveMessage(QByteArray::fromRawData(reinterpret_cast<const char*>(data), message_size));
     }
-
-    emit haveMessage(buf);
-}
-
-void SSLClient::readPendingDatagrams()
-{
-    while (_udp_socket->hasPendingDatagrams())
+    if(_read_offset >= _read_buffer.size())
     {
-        QByteArray datagram;
-        datagram.resize(_udp_socket->pendingDatagramSize());
-        QHostAddress sender;
-        quint16 senderPort;
-
-        _udp_socket->readDatagram(datagram.data(), datagram.size(),
-                             &sender, &senderPort);
-
-        emit haveUDPData(datagram);
+        _read_buffer.resize(0);
+        _read_offset = 0;
+    }
+    else if(_read_offset > 4096)
+    {
+        // move the partial message to the front instead of growing forever
+        _read_buffer.remove(0, _read_offset);
+        _read_offset = 0;
     }
-}
-
-void SSLClient::sendUDP(quint8 *payload, quint64 size)
-{
-    char *message = reinterpret_cast<char*>(payload);
-
-    quint64 sent = _udp_socket->writeDatagram(message,size,QHostAddress(_hostname),_port);
-    _udp_socket->flush();
-    if(sent <= 0)
-        std::cerr << "UDP transmit error" << std::endl;
-
 }
 
 
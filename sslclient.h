@@ -22,16 +22,17 @@
 #include <QSslCipher>
 #include <QSslCertificate>
 #include <QAbstractSocket>
-#include <QUdpSocket>
 #include <QHostAddress>
 #include <QObject>
 #include <QString>
 #include <QStringList>
 #include <QTime>
+#include <QTimer>
 #include <QCoreApplication>
 #include <unistd.h>
 #include <iostream>
 #include "config_defines.h"
+#include "ext/utils.h"
 
 class SSLClient : public QObject
 {
@@ -41,7 +42,7 @@ public:
     ~SSLClient();
 
     void sendBin(quint8 *payload, quint64 size);
-    void sendUDP(quint8 *payload, quint64 size);
+    void setMaxWriteDelay(int ms);
     int connectionStatus();
     void disconnectHost();
     QSslCipher getCipher();
@@ -50,23 +51,34 @@ public:
 public slots:
     void processData();
     void connectHost(const QString &host, const unsigned &port);
-    void readPendingDatagrams();
 
 signals:
     void connectionFailure();
     void connectedToHost();
     void haveMessage(QByteArray buf);
-    void haveUDPData(QByteArray buf);
     void disconnectedFromHost();
 
 private:
     QSslSocket *_socket;
-    QUdpSocket *_udp_socket;
     unsigned _connection_tries;
     unsigned _status;
     QString _hostname;
     unsigned _port;
     bool _reconnect;
+    // received bytes, messages before _read_offset were already dispatched
+    QByteArray _read_buffer;
+    int _read_offset;
+    // messages waiting to go out together in one TLS record
+    QByteArray _write_buffer;
+    QTimer *_write_timer;
+    int _max_write_delay;
+
+    enum
+    {
+        PreambleSize = 6, // 16 bit type, 32 bit length
+        MaxMessageSize = 0x7fffff,
+        MaxRecordSize = 16384 // TLS record payload limit
+    };
 
 
 private slots:
@@ -74,6 +86,7 @@ private slots:
     void connectionFailed(QAbstractSocket::SocketError);
     void sslError(QList<QSslError> errors);
     void tryReconnect();
+    void flushWrites();
 
 };
 
@@ -0,0 +1,550 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#include "udpvoice.h"
+#include <sys/types.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <string.h>
+#include <algorithm>
+
+UDPVoice::UDPVoice(Settings *settings, QObject *parent) :
+    QObject(parent)
+{
+    _settings = settings;
+    _encoder = new AudioEncoder;
+    _encoder->set_opus_profile(_settings->_opus_profile, _settings->_opus_bitrate,
+                               _settings->_opus_complexity, _settings->_opus_packet_loss);
+#ifndef NO_CRYPT
+    _crypt_state = new CryptState;
+#endif
+    _crypt_keyed = false;
+    _socket = -1;
+    _server_port = MUMBLE_PORT;
+    _streaming = false;
+    _tx_batch_count = 0;
+    _voice_frame_count = 0;
+    _frames_per_packet = std::max(1, std::min((int)MaxVoiceFrames, _settings->_mumble_frames_per_packet));
+    _last_voice_frame = 0;
+    _sequence_number = 0;
+    _last_expiry = 0;
+    // receive buffers are set up once, recvmmsg only fills in the lengths
+    memset(_rx_msgs, 0, sizeof(_rx_msgs));
+    for(int i=0;i<BatchSize;i++)
+    {
+        _rx_iov[i].iov_base = _rx_buffers[i];
+        _rx_iov[i].iov_len = MaxDatagramSize;
+        _rx_msgs[i].msg_hdr.msg_iov = &_rx_iov[i];
+        _rx_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+UDPVoice::~UDPVoice()
+{
+    if(_socket >= 0)
+        close(_socket);
+    QMap<quint64, session_decoder>::iterator it;
+    for(it = _decoders.begin();it != _decoders.end();++it)
+        delete it.value().codec;
+    delete _encoder;
+#ifndef NO_CRYPT
+    delete _crypt_state;
+#endif
+}
+
+void UDPVoice::setServer(const QString &host, unsigned port)
+{
+    _server_mutex.lock();
+    _server_host = host;
+    _server_port = port;
+    _server_mutex.unlock();
+    _server_changed.fetchAndStoreRelease(1);
+}
+
+/// Voice flows only while the client is synchronized with the server
+void UDPVoice::setActive(bool active)
+{
+    _active.fetchAndStoreRelease(active ? 1 : 0);
+}
+
+/// The crypt state belongs to the voice thread, it is keyed there
+void UDPVoice::setCryptKey(const std::string &key, const std::string &client_nonce,
+                           const std::string &server_nonce)
+{
+    crypt_key setup;
+    setup.key = key;
+    setup.client_nonce = client_nonce;
+    setup.server_nonce = server_nonce;
+    if(!_crypt_keys.push(setup))
+        qDebug() << "Voice crypt setup dropped";
+}
+
+/// Called directly from another thread, the loop does not process events
+void UDPVoice::stop()
+{
+    _stop.fetchAndStoreRelease(1);
+}
+
+void UDPVoice::sendAudio(PcmFrame pcm)
+{
+    // a full queue means the voice thread is stuck, dropping is better than blocking
+    _tx_audio.push(pcm);
+}
+
+void UDPVoice::sendPing()
+{
+    quint8 head = 32;
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    quint64 ts=now.tv_sec*1000000+now.tv_usec;
+    ByteFrame ping(sizeof(quint8) + sizeof(quint64));
+    memcpy(ping.data(),&head,sizeof(quint8));
+    memcpy(ping.data()+sizeof(quint8),&ts,sizeof(quint64));
+    _tx_control.push(ping);
+}
+
+void UDPVoice::receiveTunnel(const ByteFrame &packet)
+{
+    _rx_tunnel.push(packet);
+}
+
+/// Port the voice socket is bound to, 0 while there is none
+int UDPVoice::localPort()
+{
+    return _local_port.fetchAndAddAcquire(0);
+}
+
+bool UDPVoice::getAudio(PcmFrame &pcm, quint64 &session_id)
+{
+    received_audio audio;
+    if(!_rx_audio.pop(audio))
+        return false;
+    pcm = audio.pcm;
+    session_id = audio.session_id;
+    return true;
+}
+
+void UDPVoice::run()
+{
+    _clock.start();
+    while(!_stop.fetchAndAddAcquire(0))
+    {
+        if(_server_changed.fetchAndStoreAcquire(0))
+            openSocket();
+        updateCrypt();
+        bool active = (_active.fetchAndAddAcquire(0) != 0);
+        if(active != _streaming)
+        {
+            resetStream();
+            _streaming = active;
+        }
+        if(_socket >= 0)
+        {
+            struct pollfd pfd;
+            pfd.fd = _socket;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            // short timeout, outgoing audio is picked up on the next pass
+            if(poll(&pfd, 1, 2) > 0)
+                receiveDatagrams();
+        }
+        else
+        {
+            usleep(2000);
+        }
+        ByteFrame packet;
+        while(_rx_tunnel.pop(packet))
+        {
+            if(_streaming)
+                processVoicePacket(packet.constData(), packet.size(), true);
+        }
+        encodeAudio();
+        sendDatagrams();
+        expireDecoders();
+    }
+    if(_socket >= 0)
+    {
+        close(_socket);
+        _socket = -1;
+    }
+    _local_port.fetchAndStoreRelease(0);
+    emit finished();
+}
+
+void UDPVoice::openSocket()
+{
+    _server_mutex.lock();
+    QByteArray host = _server_host.toLocal8Bit();
+    QByteArray port = QByteArray::number(_server_port);
+    _server_mutex.unlock();
+    if(_socket >= 0)
+    {
+        close(_socket);
+        _socket = -1;
+    }
+    _local_port.fetchAndStoreRelease(0);
+    struct addrinfo hints;
+    struct addrinfo *server;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if(getaddrinfo(host.constData(), port.constData(), &hints, &server) != 0)
+    {
+        std::cerr << "Could not resolve voice server " << host.constData() << std::endl;
+        return;
+    }
+    _socket = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in local;
+    memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    // an ephemeral port, so several clients on one host each get a socket
+    local.sin_port = htons(0);
+    // connected, so the kernel filters foreign datagrams and sends need no address
+    if((_socket < 0) || (bind(_socket, (struct sockaddr*)&local, sizeof(local)) < 0) ||
+            (::connect(_socket, server->ai_addr, server->ai_addrlen) < 0))
+    {
+        std::cerr << "Voice socket setup failed" << std::endl;
+        if(_socket >= 0)
+            close(_socket);
+        _socket = -1;
+    }
+    freeaddrinfo(server);
+    if(_socket < 0)
+        return;
+    socklen_t local_size = sizeof(local);
+    if(getsockname(_socket, (struct sockaddr*)&local, &local_size) == 0)
+        _local_port.fetchAndStoreRelease(ntohs(local.sin_port));
+}
+
+void UDPVoice::updateCrypt()
+{
+    crypt_key setup;
+    while(_crypt_keys.pop(setup))
+    {
+#ifndef NO_CRYPT
+        _crypt_state->setKey(reinterpret_cast<const unsigned char*>(setup.key.c_str()),
+                             reinterpret_cast<const unsigned char*>(setup.client_nonce.c_str()),
+                             reinterpret_cast<const unsigned char*>(setup.server_nonce.c_str()));
+#endif
+        _crypt_keyed = true;
+    }
+}
+
+/// A new session starts with fresh sequence numbers and decoder state
+void UDPVoice::resetStream()
+{
+    _tx_audio.clear();
+    _voice_frame_count = 0;
+    _sequence_number = 0;
+    QMap<quint64, session_decoder>::iterator it;
+    for(it = _decoders.begin();it != _decoders.end();++it)
+        delete it.value().codec;
+    _decoders.clear();
+}
+
+void UDPVoice::receiveDatagrams()
+{
+    int received;
+    do
+    {
+        received = recvmmsg(_socket, _rx_msgs, BatchSize, MSG_DONTWAIT, NULL);
+        if(!_streaming)
+            continue;
+        for(int i=0;i<received;i++)
+        {
+            processVoicePacket(_rx_buffers[i], _rx_msgs[i].msg_len, false);
+        }
+    } while(received == BatchSize);
+}
+
+void UDPVoice::processVoicePacket(const unsigned char *data, int size, bool tunnel)
+{
+#ifndef NO_CRYPT
+    unsigned char decrypted[MaxDatagramSize];
+    if(!tunnel)
+    {
+        if((size <= 4) || !_crypt_keyed || !_crypt_state->decrypt(data, decrypted, size))
+            return;
+        data = decrypted;
+        size -= 4;
+    }
+#endif
+    if(size < 2)
+        return;
+    quint8 type = data[0] >> 5;
+    if(type == 1) // UDP ping reply
+        return;
+    PacketDataStream pds(reinterpret_cast<const char*>(data+1), size-1);
+    quint64 seq_number;
+    quint64 session;
+    quint8 audio_head;
+    pds >> session;
+    pds >> seq_number;
+    pds >> audio_head;
+    if(tunnel) // Received UDPTunnel
+    {
+        type = audio_head >> 5;
+    }
+    int audio_size = pds.left();
+    if(!pds.isValid() || (audio_size <= 0))
+    {
+        qDebug() << "malformed audio frame";
+        return;
+    }
+    // decoded straight from the receive buffer
+    decodeAudio(reinterpret_cast<const unsigned char*>(pds.charPtr()), audio_size, type, session,
+                seq_number);
+}
+
+void UDPVoice::decodeAudio(const unsigned char *audio, int size, quint8 type, quint64 session_id,
+                           quint64 seq_number)
+{
+    // decoders keep per stream state, so every speaker gets its own
+    QMap<quint64, session_decoder>::iterator it = _decoders.find(session_id);
+    if(it == _decoders.end())
+    {
+        session_decoder decoder;
+        decoder.codec = new AudioEncoder;
+        decoder.last_seq = -1;
+        decoder.seq_step = 0;
+        decoder.packet_samples = 0;
+        it = _decoders.insert(session_id, decoder);
+    }
+    session_decoder &decoder = it.value();
+    decoder.last_used = _clock.elapsed();
+    AudioEncoder *codec = decoder.codec;
+
+    int samples =0;
+    PcmFrame pcm(AudioEncoder::OpusMaxPacketSamples);
+    if(type == 5)
+    {
+        samples = codec->decode_codec2(audio, size, pcm.data());
+    }
+    else
+    {
+        qint64 seq = (qint64)seq_number;
+        if((decoder.last_seq >= 0) && (seq > decoder.last_seq))
+        {
+            // clients count sequence numbers in different frame units, the
+            // smallest advance seen is taken as one packet
+            qint64 advance = seq - decoder.last_seq;
+            if((decoder.seq_step == 0) || (advance < decoder.seq_step))
+                decoder.seq_step = advance;
+            // a few packets went missing, conceal them and rebuild the last
+            // frame from the in-band FEC data of this packet
+            qint64 lost = advance / decoder.seq_step - 1;
+            if((lost > 0) && (lost <= MaxLostPackets) && (decoder.packet_samples > 0))
+            {
+                int missing = std::min((int)AudioEncoder::OpusMaxPacketSamples,
+                                       (int)lost * decoder.packet_samples);
+                PcmFrame recovered(missing);
+                int recovered_samples = codec->decode_opus_fec(audio, size, recovered.data(), missing);
+                if(recovered_samples > 0)
+                    queueAudio(session_id, recovered.constData(), recovered_samples);
+            }
+        }
+        samples = codec->decode_opus(audio, size, pcm.data(), AudioEncoder::OpusMaxPacketSamples);
+        if(samples > 0)
+            decoder.packet_samples = samples;
+        if(seq > decoder.last_seq)
+            decoder.last_seq = seq;
+    }
+    if(samples <= 0)
+        return;
+    queueAudio(session_id, pcm.constData(), samples);
+}
+
+/// Multi-frame packets are handed on in voice blocks, like single frames
+bool UDPVoice::queueAudio(quint64 session_id, const short *pcm, int samples)
+{
+    for(int i=0;i<samples;i+=AudioEncoder::MaxFrameSamples)
+    {
+        received_audio block;
+        block.session_id = session_id;
+        block.pcm = PcmFrame(pcm + i, std::min((int)AudioEncoder::MaxFrameSamples, samples - i));
+        // the consumer is not keeping up, drop instead of waiting for it
+        if(!_rx_audio.push(block))
+            return false;
+    }
+    return true;
+}
+
+void UDPVoice::encodeAudio()
+{
+    PcmFrame pcm;
+    while(_tx_audio.pop(pcm))
+    {
+        if(!_streaming)
+            continue;
+        int audiobuffersize = pcm.size()*sizeof(short);
+        int packet_size = 0;
+        unsigned char encoded_audio[AudioEncoder::MaxFrameBytes];
+        if(_settings->_use_codec2)
+            packet_size = _encoder->encode_codec2(pcm.constData(), audiobuffersize, encoded_audio);
+        else
+            packet_size = _encoder->encode_opus(pcm.constData(), audiobuffersize, encoded_audio);
+        if(packet_size <= 0)
+            continue;
+        if(_settings->_use_codec2 || (_frames_per_packet < 2))
+            createVoicePacket(encoded_audio, packet_size);
+        else
+            queueVoiceFrame(encoded_audio, packet_size);
+    }
+    // a talk spurt rarely ends on a packet boundary, send the tail once frames stop coming
+    if((_voice_frame_count > 0) && (_clock.elapsed() - _last_voice_frame > 60))
+        flushVoiceFrames();
+}
+
+void UDPVoice::queueVoiceFrame(const unsigned char *encoded, int size)
+{
+    memcpy(_voice_frames[_voice_frame_count], encoded, size);
+    _voice_frame_sizes[_voice_frame_count] = size;
+    _voice_frame_count++;
+    _last_voice_frame = _clock.elapsed();
+    if(_voice_frame_count >= _frames_per_packet)
+        flushVoiceFrames();
+}
+
+void UDPVoice::flushVoiceFrames()
+{
+    if(_voice_frame_count < 1)
+        return;
+    const unsigned char *frames[MaxVoiceFrames];
+    for(int i=0;i<_voice_frame_count;i++)
+        frames[i] = _voice_frames[i];
+    unsigned char joined[MaxVoiceFrames * AudioEncoder::OpusMaxPacketBytes + 8];
+    int joined_size = _encoder->join_opus(frames, _voice_frame_sizes, _voice_frame_count,
+                                          joined, sizeof(joined));
+    if(joined_size > 0)
+    {
+        createVoicePacket(joined, joined_size);
+    }
+    else
+    {
+        // the encoder changed configuration inside the packet, send the frames one by one
+        for(int i=0;i<_voice_frame_count;i++)
+            createVoicePacket(_voice_frames[i], _voice_frame_sizes[i]);
+    }
+    _voice_frame_count = 0;
+}
+
+void UDPVoice::createVoicePacket(const unsigned char *encoded, int packet_size)
+{
+    int type = 0;
+    if(_settings->_use_codec2)
+        type |= (5 << 5);
+    else
+        type |= (4 << 5);
+
+    ByteFrame datagram(MaxDatagramSize);
+    datagram[0] = static_cast<unsigned char>(type);
+    PacketDataStream pds(datagram.data() + 1, MaxDatagramSize - 1);
+    int nr_of_frames = opus_packet_get_nb_frames(encoded, packet_size);
+    if(nr_of_frames < 1)
+        nr_of_frames = 1;
+
+    pds << _sequence_number;
+    _sequence_number += nr_of_frames;
+    pds << packet_size;
+    pds.append(reinterpret_cast<const char*>(encoded), packet_size);
+    datagram.resize(pds.size() + 1);
+
+    if(_settings->_mumble_tcp) // TCP tunnel
+        emit tunnelPacket(datagram);
+    else
+        queueDatagram(datagram);
+}
+
+void UDPVoice::queueDatagram(const ByteFrame &datagram)
+{
+#ifndef NO_CRYPT
+    if(!_crypt_keyed)
+        return;
+    ByteFrame encrypted(datagram.size() + 4);
+    _crypt_state->encrypt(datagram.constData(), encrypted.data(), datagram.size());
+    _tx_batch[_tx_batch_count++] = encrypted;
+#else
+    _tx_batch[_tx_batch_count++] = datagram;
+#endif
+    if(_tx_batch_count >= BatchSize)
+        flushBatch();
+}
+
+void UDPVoice::sendDatagrams()
+{
+    ByteFrame datagram;
+    while(_tx_control.pop(datagram))
+        queueDatagram(datagram);
+    if(_tx_batch_count > 0)
+        flushBatch();
+}
+
+void UDPVoice::flushBatch()
+{
+    if(_socket >= 0)
+    {
+        struct iovec iov[BatchSize];
+        struct mmsghdr msgs[BatchSize];
+        memset(msgs, 0, sizeof(msgs));
+        for(int i=0;i<_tx_batch_count;i++)
+        {
+            iov[i].iov_base = _tx_batch[i].data();
+            iov[i].iov_len = _tx_batch[i].size();
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int sent = 0;
+        while(sent < _tx_batch_count)
+        {
+            int result = sendmmsg(_socket, msgs + sent, _tx_batch_count - sent, 0);
+            if(result <= 0)
+            {
+                std::cerr << "UDP transmit error" << std::endl;
+                break;
+            }
+            sent += result;
+        }
+    }
+    for(int i=0;i<_tx_batch_count;i++)
+        _tx_batch[i] = ByteFrame();
+    _tx_batch_count = 0;
+}
+
+/// Decoders of speakers that left are freed after a while without packets
+void UDPVoice::expireDecoders()
+{
+    qint64 now = _clock.elapsed();
+    if(now - _last_expiry < 1000)
+        return;
+    _last_expiry = now;
+    QMap<quint64, session_decoder>::iterator it = _decoders.begin();
+    while(it != _decoders.end())
+    {
+        if(now - it.value().last_used > DecoderIdleMs)
+        {
+            delete it.value().codec;
+            it = _decoders.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,166 @@
+// Written by Adrian Musceac YO8RZZ , started October 2026.
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 3 of the
+// License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+
+#ifndef UDPVOICE_H
+#define UDPVOICE_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <iostream>
+#include <string>
+#include "ext/PacketDataStream.h"
+#include "ext/framebuffer.h"
+#include "ext/spscqueue.h"
+#include "audio/audioencoder.h"
+#include "config_defines.h"
+#include "settings.h"
+
+/**
+ * @brief Mumble voice path, running on its own thread.
+ *
+ * Owns the UDP voice socket and the voice codecs. The loop in run()
+ * receives datagrams in batches with recvmmsg, decodes them in place with
+ * one decoder per speaker and hands the audio to the consumer through a
+ * lock-free queue. Outgoing audio arrives the same way from RadioOp, is
+ * encoded and packed here and leaves in batches with sendmmsg. The
+ * MumbleClient control connection can stall without delaying voice.
+ *
+ * Queue roles: sendAudio() is called from the thread producing audio,
+ * getAudio() from the thread consuming it, the remaining public calls
+ * from the MumbleClient thread.
+ */
+class UDPVoice : public QObject
+{
+    Q_OBJECT
+public:
+    explicit UDPVoice(Settings *settings, QObject *parent = 0);
+    ~UDPVoice();
+    void setServer(const QString &host, unsigned port);
+    void setActive(bool active);
+    void setCryptKey(const std::string &key, const std::string &client_nonce,
+                     const std::string &server_nonce);
+    void sendPing();
+    void receiveTunnel(const ByteFrame &packet);
+    bool getAudio(PcmFrame &pcm, quint64 &session_id);
+    int localPort();
+
+signals:
+    void tunnelPacket(ByteFrame packet);
+    void finished();
+
+public slots:
+    void run();
+    void stop();
+    void sendAudio(PcmFrame pcm);
+
+private:
+    enum
+    {
+        BatchSize = 16,
+        MaxDatagramSize = 1024,
+        MaxLostPackets = 3, // longer gaps are taken as a pause, not as loss
+        MaxVoiceFrames = 3, // 3 x 40 ms, the longest Opus packet
+        DecoderIdleMs = 30000
+    };
+
+    struct crypt_key
+    {
+        std::string key;
+        std::string client_nonce;
+        std::string server_nonce;
+    };
+
+    struct received_audio
+    {
+        quint64 session_id;
+        PcmFrame pcm;
+    };
+
+    struct session_decoder
+    {
+        AudioEncoder *codec;
+        qint64 last_used;
+        qint64 last_seq; // -1 until the first packet
+        qint64 seq_step; // smallest sequence advance seen between packets
+        int packet_samples;
+    };
+
+    void openSocket();
+    void updateCrypt();
+    void resetStream();
+    void receiveDatagrams();
+    void processVoicePacket(const unsigned char *data, int size, bool tunnel);
+    void decodeAudio(const unsigned char *audio, int size, quint8 type, quint64 session_id,
+                     quint64 seq_number);
+    bool queueAudio(quint64 session_id, const short *pcm, int samples);
+    void encodeAudio();
+    void queueVoiceFrame(const unsigned char *encoded, int size);
+    void flushVoiceFrames();
+    void createVoicePacket(const unsigned char *encoded, int size);
+    void queueDatagram(const ByteFrame &datagram);
+    void sendDatagrams();
+    void flushBatch();
+    void expireDecoders();
+
+    Settings *_settings;
+    AudioEncoder *_encoder;
+    QMap<quint64, session_decoder> _decoders;
+#ifndef NO_CRYPT
+    CryptState *_crypt_state;
+#endif
+    bool _crypt_keyed;
+    int _socket;
+    QAtomicInt _local_port;
+    QMutex _server_mutex;
+    QString _server_host;
+    unsigned _server_port;
+    QAtomicInt _server_changed;
+    QAtomicInt _active;
+    QAtomicInt _stop;
+    bool _streaming;
+
+    SpscQueue<PcmFrame, 64> _tx_audio;
+    SpscQueue<ByteFrame, 16> _tx_control;
+    SpscQueue<crypt_key, 4> _crypt_keys;
+    SpscQueue<ByteFrame, 64> _rx_tunnel;
+    SpscQueue<received_audio, 256> _rx_audio;
+
+    unsigned char _rx_buffers[BatchSize][MaxDatagramSize];
+    struct iovec _rx_iov[BatchSize];
+    struct mmsghdr _rx_msgs[BatchSize];
+    ByteFrame _tx_batch[BatchSize];
+    int _tx_batch_count;
+
+    unsigned char _voice_frames[MaxVoiceFrames][AudioEncoder::OpusMaxPacketBytes];
+    int _voice_frame_sizes[MaxVoiceFrames];
+    int _voice_frame_count;
+    int _frames_per_packet;
+    qint64 _last_voice_frame;
+    quint64 _sequence_number;
+    QElapsedTimer _clock;
+    qint64 _last_expiry;
+};
+
+#endif // UDPVOICE_H